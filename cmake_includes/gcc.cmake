@@ -3,17 +3,34 @@ CHECK_CXX_COMPILER_FLAG("-Werror" KATOR_COMPILER_SUPPORTS_WERROR)
 CHECK_CXX_COMPILER_FLAG("-Wall" KATOR_COMPILER_SUPPORTS_WALL)
 CHECK_CXX_COMPILER_FLAG("-Wextra" KATOR_COMPILER_SUPPORTS_WEXTRA)
 CHECK_CXX_COMPILER_FLAG("-pedantic" KATOR_COMPILER_SUPPORTS_PEDANTIC)
-if(NOT NO_ARCHNATIVE)
+if(NOT KATOR_NO_ARCHNATIVE)
   CHECK_CXX_COMPILER_FLAG("-march=native" KATOR_COMPILER_SUPPORTS_MARCHNATIVE)
 endif()
 if(KATOR_COMPILER_SUPPORTS_MARCHNATIVE)
   set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS}  -march=native ")
 endif()
-CHECK_CXX_COMPILER_FLAG("-mno-vzeroupper"
-  KATOR_COMPILER_SUPPORTS_MNO_VZEROUPPER)
+# With runtime dispatch, AVX code is called from code compiled
+# for SSE, and the compiler must insert vzeroupper at the boundaries
+#
+if(NOT KATOR_USE_RUNTIME_DISPATCH)
+  CHECK_CXX_COMPILER_FLAG("-mno-vzeroupper"
+    KATOR_COMPILER_SUPPORTS_MNO_VZEROUPPER)
+endif()
 if(KATOR_COMPILER_SUPPORTS_MNO_VZEROUPPER)
   set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS}  -mno-vzeroupper ")
 endif()
+# Without AVX enabled, GCC warns about every function taking or
+# returning a 32 byte vector, e.g. the u64x4 helpers in vectors.h,
+# even when inlined. Those are all internal to a translation unit,
+# no such vector is passed across the boundary of the code compiled
+# for different targets, thus the ABI change does not matter.
+#
+if(KATOR_USE_RUNTIME_DISPATCH)
+  CHECK_CXX_COMPILER_FLAG("-Wno-psabi" KATOR_COMPILER_SUPPORTS_WNO_PSABI)
+endif()
+if(KATOR_COMPILER_SUPPORTS_WNO_PSABI)
+  set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS}  -Wno-psabi ")
+endif()
 CHECK_CXX_COMPILER_FLAG("-flax-vector-conversions"
   KATOR_COMPILER_SUPPORTS_FLAX_VECTOR_CONVERSIONS)
 if(KATOR_COMPILER_SUPPORTS_FLAX_VECTOR_CONVERSIONS)
@@ -131,19 +148,16 @@ int main() {
 
 CHECK_CXX_SOURCE_RUNS("
 #include <cstdint>
- 
-typedef uint64_t vector64 __attribute__ ((vector_size(64)));
 
-vector64 test = {9, 32, 4839834, 1024};
+typedef uint64_t vector256 __attribute__ ((vector_size(32)));
 
-int main() {
-  uint64_t x;
-  unsigned char* c = (unsigned char*)(&test);
+vector256 test = {9, 32, 4839834, 1024};
+vector256 counts = {1, 2, 3, 4};
 
+int main() {
+  vector256 x = ((test << counts) | (test >> counts)) & ~counts;
 
-  c[12] = 99;
-  x = test[1];
-  return x & 0;
+  return static_cast<int>(x[1] - 136);
 }"
   KATOR_HAS_GCC_VECTOR)
 
@@ -156,46 +170,58 @@ int main() {
 }"
   KATOR_HAS_GCC_BUILTIN_PREFETCH)
 
-set(CMAKE_REQUIRED_FLAGS
-  "${orig_cmake_required_flags} ${KATOR_STANDARD_FLAG} -ffixed-xmm7")
-
 CHECK_CXX_SOURCE_RUNS("
-#include <cstdint>
+#include <immintrin.h>
 
-register uint8_t test_global_vector
-asm(\"xmm7\") __attribute__ ((__vector_size__ (16)));
+__attribute__ ((target(\"avx2\")))
+int reverse(const unsigned char* p)
+{
+  __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+  x = _mm256_permute4x64_epi64(x, 0x1b);
+  return _mm256_extract_epi8(x, 0);
+}
 
 int main() {
+  unsigned char data[32] = {0};
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports(\"avx2\")) {
+    return reverse(data);
+  }
   return 0;
 }"
-  KATOR_HAS_GCC_GLOBAL_REGISTER_VARIABLE_XMM)
-
-set(CMAKE_REQUIRED_FLAGS
-  "${orig_cmake_required_flags} ${KATOR_STANDARD_FLAG} -ffixed-xmm15")
+  KATOR_HAS_GCC_TARGET_ATTRIBUTE)
 
 CHECK_CXX_SOURCE_RUNS("
-#include <cstdint>
+#include <immintrin.h>
 
-register uint8_t test_global_vector
-asm(\"xmm15\") __attribute__ ((__vector_size__ (32)));
+__attribute__ ((target(\"avx512f,avx512bw\")))
+int reverse(const unsigned char* p)
+{
+  __m512i x = _mm512_loadu_si512(p);
+  x = _mm512_shuffle_epi8(x, x);
+  return _mm_extract_epi8(_mm512_castsi512_si128(x), 0);
+}
 
 int main() {
+  unsigned char data[64] = {0};
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports(\"avx512bw\")) {
+    return reverse(data);
+  }
   return 0;
 }"
-  KATOR_HAS_GCC_GLOBAL_REGISTER_VARIABLE_YMM)
-
-set(CMAKE_REQUIRED_FLAGS
-  "${orig_cmake_required_flags} ${KATOR_STANDARD_FLAG} -ffixed-xmm31")
+  KATOR_HAS_GCC_TARGET_ATTRIBUTE_AVX512)
 
 CHECK_CXX_SOURCE_RUNS("
 #include <cstdint>
 
-register uint8_t test_global_vector
-asm(\"xmm31\") __attribute__ ((__vector_size__ (64)));
+__attribute__ ((target_clones(\"default\", \"popcnt\", \"arch=haswell\")))
+int count(uint64_t x) { return __builtin_popcountll(x); }
 
 int main() {
-  return 0;
+  return count(0x404040) - 3;
 }"
-  KATOR_HAS_GCC_GLOBAL_REGISTER_VARIABLE_ZMM) 
+  KATOR_HAS_GCC_TARGET_CLONES)
+
 set(CMAKE_REQUIRED_FLAGS "${orig_cmake_required_flags} ${KATOR_STANDARD_FLAG}")
 
@@ -2,6 +2,7 @@
 
 SET(KATOR_COMMON_SOURCES 
      src/chess/position.cc
+     src/chess/copy_and_flip.cc
      src/chess/bitboard.cc
      src/chess/move_list.cc
      src/chess/game_state.cc
@@ -17,11 +18,21 @@ SET(KATOR_COMMON_SOURCES
      src/kator.cc
 
      src/platform/platform.cc
+     src/platform/block_pool.cc
 
      src/engine/zhash_table.cc
      src/engine/engine.cc
      src/engine/eval.cc
      src/engine/search.cc
+     src/engine/search_stack.cc
+     src/engine/move_order.cc
+     src/engine/pawn_table.cc
+     src/engine/material_table.cc
+     src/engine/endgame.cc
+     src/engine/eval_cache.cc
+     src/engine/activity.cc
+     src/engine/nnue.cc
+     src/engine/evaluator.cc
 
      )
 
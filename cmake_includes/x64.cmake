@@ -103,6 +103,26 @@ int main() {
 }"
   KATOR_HAS_X64_256BIT_AVX2_BUILTINS)
 
+CHECK_CXX_SOURCE_RUNS("
+    // AVX-512 F and BW
+#include <cstdint>
+#include <immintrin.h>
+
+int main() {
+  uint64_t data[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+  __m512i index = _mm512_setr_epi64(7, 6, 5, 4, 3, 2, 1, 0);
+  __m512i key = _mm512_broadcast_i32x4(
+                  _mm_setr_epi8(15, 14, 13, 12, 11, 10,  9,  8,
+                                 7,  6,  5,  4,  3,  2,  1,  0));
+  __m512i a = _mm512_maskz_loadu_epi64(0x0f, data);
+
+  a = _mm512_permutexvar_epi64(index, a);
+  a = _mm512_shuffle_epi8(a, key);
+  _mm512_mask_storeu_epi64(data, 0x0f, a);
+  return static_cast<int>(data[0]) & 0;
+}"
+  KATOR_HAS_X64_512BIT_AVX512BW_BUILTINS)
+
 CHECK_CXX_SOURCE_RUNS("
 #include <cstdint>
 #include <immintrin.h>
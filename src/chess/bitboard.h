@@ -53,11 +53,15 @@ private:
     return UINT64_C(1) << index.offset();
   }
 
-  static std::array<bitboard, 64> knight_table;
-  static std::array<bitboard, 64> bishop_pattern_table;
-  static std::array<bitboard, 64> rook_pattern_table;
-  static std::array<bitboard, 64> king_table;
-  static std::array<bitboard, 64*64> rays;
+  /* The lookup tables are generated at build time, and are {{{
+     compiled into read-only data, thus these need no setup before use.
+     See tools/attack_table_generator.cc
+  }}}*/
+  static const std::array<bitboard, 64> knight_table;
+  static const std::array<bitboard, 64> bishop_pattern_table;
+  static const std::array<bitboard, 64> rook_pattern_table;
+  static const std::array<bitboard, 64> king_table;
+  static const std::array<bitboard, 64*64> rays;
 
 public:
 
@@ -85,18 +89,21 @@ public:
 
     friend bitboard;
 
-    static std::array<magical, 64> bishop;
-    static std::array<magical, 64> rook;
-
-    static void lookup_tables_init();
+    static const std::array<magical, 64> bishop;
+    static const std::array<magical, 64> rook;
   };
 
 #else // defined(KATOR_USE_PEXT_BITBOARD)
 
+  /* The magic index selects the attack set among the few distinct {{{
+     ones of the square -- at most 144 for a rook -- stored in a byte,
+     the attack sets themselves are in a second, much smaller table.
+  }}}*/
   struct magical {
     uint64_t pre_mask;
     uint64_t multiplier;
-    const bitboard *attacks;
+    const uint8_t* attack_indices;
+    const uint64_t* attacks;
     uint64_t shift;
 
     size_t offset(uint64_t occupied) const
@@ -107,15 +114,13 @@ public:
 
     bitboard pattern(uint64_t occupied) const
     {
-      return attacks[offset(occupied)];
+      return bitboard(attacks[attack_indices[offset(occupied)]]);
     }
 
     friend bitboard;
 
-    static std::array<magical, 64> bishop;
-    static std::array<magical, 64> rook;
-
-    static void lookup_tables_init();
+    static const std::array<magical, 64> bishop;
+    static const std::array<magical, 64> rook;
   };
 
 #endif // !defined(KATOR_USE_PEXT_BITBOARD)
@@ -141,7 +141,8 @@ inline void castle_rights::clear_side(side side)
 
 static inline castle_rights::side opponent_of(castle_rights::side side)
 {
-  return static_cast<castle_rights::side>(static_cast<unsigned>(side) ^ 1); }
+  return static_cast<castle_rights::side>(static_cast<unsigned>(side) ^ 2);
+}
 
 } /* namespace kator */
 
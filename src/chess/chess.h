@@ -264,8 +264,6 @@ std::unique_ptr<game_state> parse_fen(std::istream&);
 
 std::ostream& operator<< (std::ostream&, real_player);
 
-void bitboard_lookup_tables_init();
-
 void cleanup_move_string(std::string&);
 
 std::ostream& operator<< (std::ostream&, sq_index);
@@ -0,0 +1,53 @@
+
+#include "copy_and_flip.h"
+
+/* Without the target attribute, the vector implementations are {{{
+   only compiled when the compiler flags allow their use anyway.
+}}}*/
+#ifdef KATOR_COPY_AND_FLIP_CPU_CHECK
+#  define REQUIRED_FEATURE(feature) (&cpu_features::feature)
+#else
+#  define REQUIRED_FEATURE(feature) nullptr
+#endif
+
+namespace kator
+{
+
+const copy_and_flip_implementation copy_and_flip_implementations[] = {
+  { "portable", nullptr,
+    portable_board_copy_and_flip, portable_piece_map_copy_and_flip },
+#ifdef KATOR_HAS_SSE2_COPY_AND_FLIP
+  { "sse2", nullptr,
+    sse2_board_copy_and_flip, sse2_piece_map_copy_and_flip },
+#endif
+#ifdef KATOR_HAS_SSSE3_COPY_AND_FLIP
+  { "ssse3", REQUIRED_FEATURE(ssse3),
+    sse2_board_copy_and_flip, ssse3_piece_map_copy_and_flip },
+#endif
+#ifdef KATOR_HAS_AVX2_COPY_AND_FLIP
+  { "avx2", REQUIRED_FEATURE(avx2),
+    avx2_board_copy_and_flip, avx2_piece_map_copy_and_flip },
+#endif
+#ifdef KATOR_HAS_AVX512_COPY_AND_FLIP
+  { "avx512", REQUIRED_FEATURE(avx512bw),
+    avx512_board_copy_and_flip, avx512_piece_map_copy_and_flip },
+#endif
+};
+
+const size_t copy_and_flip_implementation_count =
+  sizeof(copy_and_flip_implementations)
+  / sizeof(copy_and_flip_implementations[0]);
+
+const copy_and_flip_implementation& best_copy_and_flip()
+{
+  size_t best = 0;
+
+  for (size_t i = 0; i < copy_and_flip_implementation_count; ++i) {
+    if (copy_and_flip_implementations[i].is_supported()) {
+      best = i;
+    }
+  }
+  return copy_and_flip_implementations[best];
+}
+
+} /* namespace kator */
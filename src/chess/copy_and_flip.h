@@ -0,0 +1,272 @@
+
+#ifndef KATOR_CHESS_COPY_AND_FLIP_H
+#define KATOR_CHESS_COPY_AND_FLIP_H
+
+#include <cstring>
+
+#include "platform/platform.h"
+#include "chess.h"
+#include "bitboard.h"
+
+/* Copying the board and the piece maps of a position into a child {{{
+   position, while flipping them to the point of view of the other side.
+   The board is 64 bytes, flipped by reversing the order of its 8 byte
+   rows. The piece maps are stored in pairs ( pawn, opponent_pawn ... ),
+   thus a 16 byte reversal both byte swaps each bitboard, and swaps the
+   two bitboards in a pair -- which is exactly what the flip needs.
+   There is an implementation for each x86 vector extension that helps
+   here. With a compiler supporting the target attribute all of them are
+   compiled, and one can be chosen at runtime, otherwise only the ones
+   enabled by the compiler flags in use are available.
+   None of these assume any alignment.
+}}}*/
+
+#if defined(KATOR_HAS_GCC_TARGET_ATTRIBUTE) \
+    && defined(KATOR_HAS_X64_128BIT_BUILTINS)
+
+#  define KATOR_COPY_AND_FLIP_TARGET(x) __attribute__ ((target(x)))
+#  define KATOR_COPY_AND_FLIP_CPU_CHECK
+#  define KATOR_HAS_SSE2_COPY_AND_FLIP
+#  define KATOR_HAS_SSSE3_COPY_AND_FLIP
+#  define KATOR_HAS_AVX2_COPY_AND_FLIP
+#  ifdef KATOR_HAS_GCC_TARGET_ATTRIBUTE_AVX512
+#    define KATOR_HAS_AVX512_COPY_AND_FLIP
+#  endif
+
+#else
+
+#  define KATOR_COPY_AND_FLIP_TARGET(x)
+#  ifdef KATOR_HAS_X64_128BIT_BUILTINS
+#    define KATOR_HAS_SSE2_COPY_AND_FLIP
+#  endif
+#  ifdef KATOR_HAS_X64_128BIT_SSSE3_SHUFFLE_BUILTIN
+#    define KATOR_HAS_SSSE3_COPY_AND_FLIP
+#  endif
+#  ifdef KATOR_HAS_X64_256BIT_AVX2_BUILTINS
+#    define KATOR_HAS_AVX2_COPY_AND_FLIP
+#  endif
+#  ifdef KATOR_HAS_X64_512BIT_AVX512BW_BUILTINS
+#    define KATOR_HAS_AVX512_COPY_AND_FLIP
+#  endif
+
+#endif
+
+#ifdef KATOR_HAS_SSE2_COPY_AND_FLIP
+#  include <immintrin.h>
+#endif
+
+namespace kator
+{
+
+typedef void board_flip_kernel(unsigned char* RESTRICT dst,
+                               const unsigned char* RESTRICT src);
+typedef void piece_map_flip_kernel(uint64_t* RESTRICT dst,
+                                   const uint64_t* RESTRICT src);
+
+/* The number of bitboards copied, the piece maps of both sides */
+constexpr size_t flipped_piece_map_count = piece_array_size - 2;
+
+static_assert(flipped_piece_map_count % 4 == 0,
+              "piece maps expected to fill whole 256 bit vectors");
+
+static inline void
+portable_board_copy_and_flip(unsigned char* RESTRICT dst,
+                             const unsigned char* RESTRICT src)
+{
+  for (int i = 0; i < 64; i += 8) {
+    std::memcpy(dst + (56 - i), src + i, 8);
+  }
+}
+
+static inline void
+portable_piece_map_copy_and_flip(uint64_t* RESTRICT dst,
+                                 const uint64_t* RESTRICT src)
+{
+  for (size_t i = 0; i < flipped_piece_map_count; ++i) {
+    dst[i] = flip(bitboard(src[i ^ 1])).to_uint64_t();
+  }
+}
+
+#ifdef KATOR_HAS_SSE2_COPY_AND_FLIP
+
+KATOR_COPY_AND_FLIP_TARGET("sse2")
+static inline void
+sse2_board_copy_and_flip(unsigned char* RESTRICT dst,
+                         const unsigned char* RESTRICT src)
+{
+  const __m128i* vsrc = reinterpret_cast<const __m128i*>(src);
+  __m128i* vdst = reinterpret_cast<__m128i*>(dst);
+
+  for (int i = 0; i < 4; ++i) {
+    __m128i rows = _mm_loadu_si128(vsrc + i);
+
+    rows = _mm_shuffle_epi32(rows, _MM_SHUFFLE(1, 0, 3, 2));
+    _mm_storeu_si128(vdst + (3 - i), rows);
+  }
+}
+
+/* Without pshufb the 16 byte reversal takes three steps: {{{
+   swapping the two 64 bit halves, reversing the order of
+   16 bit words in each half, and swapping the bytes in each word.
+}}}*/
+KATOR_COPY_AND_FLIP_TARGET("sse2")
+static inline void
+sse2_piece_map_copy_and_flip(uint64_t* RESTRICT dst,
+                             const uint64_t* RESTRICT src)
+{
+  const __m128i* vsrc = reinterpret_cast<const __m128i*>(src);
+  __m128i* vdst = reinterpret_cast<__m128i*>(dst);
+
+  for (size_t i = 0; i < flipped_piece_map_count / 2; ++i) {
+    __m128i maps = _mm_loadu_si128(vsrc + i);
+
+    maps = _mm_shuffle_epi32(maps, _MM_SHUFFLE(1, 0, 3, 2));
+    maps = _mm_shufflelo_epi16(maps, _MM_SHUFFLE(0, 1, 2, 3));
+    maps = _mm_shufflehi_epi16(maps, _MM_SHUFFLE(0, 1, 2, 3));
+    maps = _mm_or_si128(_mm_slli_epi16(maps, 8), _mm_srli_epi16(maps, 8));
+    _mm_storeu_si128(vdst + i, maps);
+  }
+}
+
+#endif // KATOR_HAS_SSE2_COPY_AND_FLIP
+
+#ifdef KATOR_HAS_SSSE3_COPY_AND_FLIP
+
+KATOR_COPY_AND_FLIP_TARGET("ssse3")
+static inline void
+ssse3_piece_map_copy_and_flip(uint64_t* RESTRICT dst,
+                              const uint64_t* RESTRICT src)
+{
+  const __m128i key = _mm_setr_epi8(15, 14, 13, 12, 11, 10,  9,  8,
+                                     7,  6,  5,  4,  3,  2,  1,  0);
+  const __m128i* vsrc = reinterpret_cast<const __m128i*>(src);
+  __m128i* vdst = reinterpret_cast<__m128i*>(dst);
+
+  for (size_t i = 0; i < flipped_piece_map_count / 2; ++i) {
+    _mm_storeu_si128(vdst + i,
+                     _mm_shuffle_epi8(_mm_loadu_si128(vsrc + i), key));
+  }
+}
+
+#endif // KATOR_HAS_SSSE3_COPY_AND_FLIP
+
+#ifdef KATOR_HAS_AVX2_COPY_AND_FLIP
+
+KATOR_COPY_AND_FLIP_TARGET("avx2")
+static inline void
+avx2_board_copy_and_flip(unsigned char* RESTRICT dst,
+                         const unsigned char* RESTRICT src)
+{
+  const __m256i* vsrc = reinterpret_cast<const __m256i*>(src);
+  __m256i* vdst = reinterpret_cast<__m256i*>(dst);
+  __m256i low = _mm256_loadu_si256(vsrc);
+  __m256i high = _mm256_loadu_si256(vsrc + 1);
+
+  low = _mm256_permute4x64_epi64(low, _MM_SHUFFLE(0, 1, 2, 3));
+  high = _mm256_permute4x64_epi64(high, _MM_SHUFFLE(0, 1, 2, 3));
+  _mm256_storeu_si256(vdst, high);
+  _mm256_storeu_si256(vdst + 1, low);
+}
+
+/* vpshufb shuffles within 128 bit lanes, which is just right here */
+KATOR_COPY_AND_FLIP_TARGET("avx2")
+static inline void
+avx2_piece_map_copy_and_flip(uint64_t* RESTRICT dst,
+                             const uint64_t* RESTRICT src)
+{
+  const __m256i key = _mm256_setr_epi8(15, 14, 13, 12, 11, 10,  9,  8,
+                                        7,  6,  5,  4,  3,  2,  1,  0,
+                                       15, 14, 13, 12, 11, 10,  9,  8,
+                                        7,  6,  5,  4,  3,  2,  1,  0);
+  const __m256i* vsrc = reinterpret_cast<const __m256i*>(src);
+  __m256i* vdst = reinterpret_cast<__m256i*>(dst);
+
+  for (size_t i = 0; i < flipped_piece_map_count / 4; ++i) {
+    _mm256_storeu_si256(vdst + i,
+                        _mm256_shuffle_epi8(_mm256_loadu_si256(vsrc + i),
+                                            key));
+  }
+}
+
+#endif // KATOR_HAS_AVX2_COPY_AND_FLIP
+
+#ifdef KATOR_HAS_AVX512_COPY_AND_FLIP
+
+/* The permutation and shuffle keys are loaded from memory, and the {{{
+   permutation uses the zero masking form with all lanes selected:
+   the set/broadcast intrinsics, and the unmasked permutation, make
+   GCC 12 warn about uninitialized variables inside avx512fintrin.h.
+}}}*/
+alignas(64) static const uint64_t avx512_board_flip_index[8] = {
+  7, 6, 5, 4, 3, 2, 1, 0
+};
+
+alignas(64) static const uint64_t avx512_byte_reverse_key[8] = {
+  UINT64_C(0x08090a0b0c0d0e0f), UINT64_C(0x0001020304050607),
+  UINT64_C(0x08090a0b0c0d0e0f), UINT64_C(0x0001020304050607),
+  UINT64_C(0x08090a0b0c0d0e0f), UINT64_C(0x0001020304050607),
+  UINT64_C(0x08090a0b0c0d0e0f), UINT64_C(0x0001020304050607)
+};
+
+KATOR_COPY_AND_FLIP_TARGET("avx512f,avx512bw")
+static inline void
+avx512_board_copy_and_flip(unsigned char* RESTRICT dst,
+                           const unsigned char* RESTRICT src)
+{
+  const __m512i index = _mm512_load_si512(avx512_board_flip_index);
+
+  _mm512_storeu_si512(dst,
+                      _mm512_maskz_permutexvar_epi64(0xff, index,
+                                                     _mm512_loadu_si512(src)));
+}
+
+/* The twelve piece maps are 96 bytes, the last 32 of {{{
+   those are loaded and stored using a mask.
+}}}*/
+KATOR_COPY_AND_FLIP_TARGET("avx512f,avx512bw")
+static inline void
+avx512_piece_map_copy_and_flip(uint64_t* RESTRICT dst,
+                               const uint64_t* RESTRICT src)
+{
+  static_assert(flipped_piece_map_count == 12,
+                "unexpected number of piece maps");
+
+  const __m512i key = _mm512_load_si512(avx512_byte_reverse_key);
+  const __mmask8 tail = 0x0f;
+  __m512i head_maps = _mm512_loadu_si512(src);
+  __m512i tail_maps = _mm512_maskz_loadu_epi64(tail, src + 8);
+
+  _mm512_storeu_si512(dst, _mm512_shuffle_epi8(head_maps, key));
+  _mm512_mask_storeu_epi64(dst + 8, tail,
+                           _mm512_shuffle_epi8(tail_maps, key));
+}
+
+#endif // KATOR_HAS_AVX512_COPY_AND_FLIP
+
+/* The implementations available in this build, the first one {{{
+   being the portable code, and the last one the widest vectors.
+   Some of these might not be supported by the CPU the program
+   runs on, best_copy_and_flip returns the last one that is.
+}}}*/
+struct copy_and_flip_implementation
+{
+  const char* name;
+  bool cpu_features::* required_feature;
+  board_flip_kernel* board;
+  piece_map_flip_kernel* piece_maps;
+
+  bool is_supported() const
+  {
+    return (required_feature == nullptr)
+           or (host_cpu_features().*required_feature);
+  }
+};
+
+extern const copy_and_flip_implementation copy_and_flip_implementations[];
+extern const size_t copy_and_flip_implementation_count;
+
+const copy_and_flip_implementation& best_copy_and_flip();
+
+} /* namespace kator */
+
+#endif /* !defined(KATOR_CHESS_COPY_AND_FLIP_H) */
@@ -1,5 +1,6 @@
 
 #include "game_state.h"
+#include "platform/block_pool.h"
 
 #include <memory>
 #include <sstream>
@@ -48,6 +49,19 @@ game_state::game_state(unique_ptr<const kator::position> position_arg,
 {
 }
 
+static_assert(sizeof(game_state) <= block_pool_max_size,
+              "game states are allocated from the block pool");
+
+void* game_state::operator new(std::size_t requested_size)
+{
+  return block_pool_allocate(requested_size);
+}
+
+void game_state::operator delete(void* pointer, std::size_t size)
+{
+  block_pool_deallocate(pointer, size);
+}
+
 game_state::game_state(const game_state& other):
   game_state(*other.position,
              other.half_moves, other.full_moves,
@@ -471,7 +485,6 @@ static string print_coor_move(move move)
 
 move game_state::parse_move(const string& original_move) const
 {
-  initialize_permanent_vectors();
   string subject(original_move);
 
   cleanup_move_string(subject);
@@ -560,13 +573,13 @@ static move normalize_move(const move_list& moves, move move)
 
 unique_ptr<game_state> game_state::make_move(move move) const
 {
-  initialize_permanent_vectors();
   move = normalize_move(moves, move);
   if (turn == black) {
     move.flip();
   }
 
-  kator::position child(*position, move);
+  // Constructed in its final place, rather than copied there
+  unique_ptr<const kator::position> child(new kator::position(*position, move));
   unsigned new_full_moves;
   unsigned new_half_moves;
   sq_index ep_target = sq_index::none();
@@ -593,7 +606,7 @@ unique_ptr<game_state> game_state::make_move(move move) const
     }
   }
 
-  return unique_ptr<game_state>(new game_state(child,
+  return unique_ptr<game_state>(new game_state(std::move(child),
                                                new_half_moves,
                                                new_full_moves,
                                                opponent_of(turn),
@@ -613,7 +626,6 @@ unique_ptr<game_state> game_state::parse_fen(std::istream& fen_stream)
     unique_ptr<kator::position> position;
     fen_parser parsed(fen_stream);
 
-    initialize_permanent_vectors();
     position.reset(new ::kator::position(parsed.board, *parsed.castle,
                                          parsed.pos_ep_index, parsed.turn));
 
@@ -31,6 +31,10 @@ struct game_state
 
   game_state(const game_state&);
 
+  /* A game_state is allocated for every move made, see block_pool.h */
+  static void* operator new(size_t);
+  static void operator delete(void*, size_t);
+
   static std::unique_ptr<game_state> parse_fen(std::string);
   static std::unique_ptr<game_state> parse_fen(std::istream&);
 
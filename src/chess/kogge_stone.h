@@ -0,0 +1,150 @@
+
+#ifndef KATOR_CHESS_KOGGE_STONE_H
+#define KATOR_CHESS_KOGGE_STONE_H
+
+#include "bitboard.h"
+#include "platform/vectors.h"
+
+/* Set-wise sliding attacks, using Kogge-Stone occluded fills. {{{
+   Instead of looking up the attacks of each slider one by one, these
+   compute the attacks of a whole set of bishop-like or rook-like pieces
+   at once, in a fixed number of shifts, without any memory access.
+   The result is the union of the attacks, which is exactly what the
+   attack maps in a position are built of.
+   Each direction is filled in three steps, doubling the shift distance
+   each time. The propagator is the set of empty squares, masked to avoid
+   wrapping around from one edge of the board to the other.
+   The vector variant fills the four directions of a piece type at the
+   same time, in the four 64 bit lanes of a vector, each lane shifting
+   only either left, or right. It is only preferred where the vector
+   shifts map to single instructions, i.e. with AVX2.
+   See: https://chessprogramming.org/Kogge-Stone_Algorithm
+}}}*/
+
+namespace kator
+{
+
+namespace kogge_stone
+{
+
+constexpr uint64_t not_file_a = (compl bitboard(file_a)).to_uint64_t();
+constexpr uint64_t not_file_h = (compl bitboard(file_h)).to_uint64_t();
+
+/* Positive amounts shift towards higher square indices */
+constexpr uint64_t shifted(uint64_t value, int amount)
+{
+  return (amount > 0) ? (value << amount) : (value >> -amount);
+}
+
+static inline uint64_t
+fill_attacks(uint64_t sliders, uint64_t empty, int shift, uint64_t mask)
+{
+  uint64_t propagator = empty & mask;
+
+  sliders |= propagator & shifted(sliders, shift);
+  propagator &= shifted(propagator, shift);
+  sliders |= propagator & shifted(sliders, 2 * shift);
+  propagator &= shifted(propagator, 2 * shift);
+  sliders |= propagator & shifted(sliders, 4 * shift);
+  return shifted(sliders, shift) & mask;
+}
+
+/* left_of shifts towards higher indices, north_of towards lower ones */
+static inline bitboard
+scalar_bishop_fill_attacks(bitboard bishops, bitboard occupied)
+{
+  uint64_t sliders = bishops.to_uint64_t();
+  uint64_t empty = (compl occupied).to_uint64_t();
+
+  return bitboard(fill_attacks(sliders, empty, 9, not_file_h)
+                  | fill_attacks(sliders, empty, 7, not_file_a)
+                  | fill_attacks(sliders, empty, -7, not_file_h)
+                  | fill_attacks(sliders, empty, -9, not_file_a));
+}
+
+static inline bitboard
+scalar_rook_fill_attacks(bitboard rooks, bitboard occupied)
+{
+  uint64_t sliders = rooks.to_uint64_t();
+  uint64_t empty = (compl occupied).to_uint64_t();
+
+  return bitboard(fill_attacks(sliders, empty, 8, ~UINT64_C(0))
+                  | fill_attacks(sliders, empty, 1, not_file_h)
+                  | fill_attacks(sliders, empty, -8, ~UINT64_C(0))
+                  | fill_attacks(sliders, empty, -1, not_file_a));
+}
+
+/* Lanes shifting left, the others shift right by the same count */
+static inline u64x4
+shifted(u64x4 value, u64x4 counts, u64x4 left_lanes)
+{
+  return ((value << counts) & left_lanes)
+         | ((value >> counts) & compl left_lanes);
+}
+
+static inline uint64_t
+fill_attacks(uint64_t sliders, uint64_t empty, u64x4 counts, u64x4 masks)
+{
+  const u64x4 left_lanes = make_u64x4(~UINT64_C(0), ~UINT64_C(0), 0, 0);
+  u64x4 generator = broadcast_u64x4(sliders);
+  u64x4 propagator = broadcast_u64x4(empty) & masks;
+  u64x4 step = counts;
+
+  generator |= propagator & shifted(generator, step, left_lanes);
+  propagator &= shifted(propagator, step, left_lanes);
+  step = step + step;
+  generator |= propagator & shifted(generator, step, left_lanes);
+  propagator &= shifted(propagator, step, left_lanes);
+  step = step + step;
+  generator |= propagator & shifted(generator, step, left_lanes);
+
+  return or_of_lanes(shifted(generator, counts, left_lanes) & masks);
+}
+
+static inline bitboard
+vector_bishop_fill_attacks(bitboard bishops, bitboard occupied)
+{
+  return bitboard(fill_attacks(bishops.to_uint64_t(),
+                               (compl occupied).to_uint64_t(),
+                               make_u64x4(9, 7, 7, 9),
+                               make_u64x4(not_file_h, not_file_a,
+                                          not_file_h, not_file_a)));
+}
+
+static inline bitboard
+vector_rook_fill_attacks(bitboard rooks, bitboard occupied)
+{
+  return bitboard(fill_attacks(rooks.to_uint64_t(),
+                               (compl occupied).to_uint64_t(),
+                               make_u64x4(8, 1, 8, 1),
+                               make_u64x4(~UINT64_C(0), not_file_h,
+                                          ~UINT64_C(0), not_file_a)));
+}
+
+} /* namespace kogge_stone */
+
+static inline bitboard
+bishop_fill_attacks(bitboard bishops, bitboard occupied)
+{
+#if defined(KATOR_HAS_GCC_VECTOR) \
+    && defined(KATOR_HAS_X64_256BIT_AVX2_BUILTINS)
+  return kogge_stone::vector_bishop_fill_attacks(bishops, occupied);
+#else
+  return kogge_stone::scalar_bishop_fill_attacks(bishops, occupied);
+#endif
+}
+
+static inline bitboard
+rook_fill_attacks(bitboard rooks, bitboard occupied)
+{
+#if defined(KATOR_HAS_GCC_VECTOR) \
+    && defined(KATOR_HAS_X64_256BIT_AVX2_BUILTINS)
+  return kogge_stone::vector_rook_fill_attacks(rooks, occupied);
+#else
+  return kogge_stone::scalar_rook_fill_attacks(rooks, occupied);
+#endif
+}
+
+} /* namespace kator */
+
+#endif /* !defined(KATOR_CHESS_KOGGE_STONE_H) */
@@ -0,0 +1,79 @@
+
+#ifndef KATOR_CHESS_MATERIAL_KEY_H
+#define KATOR_CHESS_MATERIAL_KEY_H
+
+#include <cstdint>
+
+#include "chess.h"
+
+namespace kator
+{
+
+/* The count of each piece on the board, packed into one integer. {{{
+   Four bits per square type -- enough for any legal position, with
+   all the promotions -- the piece of the player to move in the lower
+   nibble of each byte, the opponent's in the upper one. Thus flipping
+   the board is swapping the nibbles.
+   Unlike a zobrist key, it has no collisions, and the counts are
+   readable from it.
+}}}*/
+class material_key
+{
+public:
+
+  constexpr material_key(): value(0) {}
+
+  void add(square piece)
+  {
+    value += unit_of(piece);
+  }
+
+  void remove(square piece)
+  {
+    value -= unit_of(piece);
+  }
+
+  constexpr unsigned count(square piece) const
+  {
+    return unsigned(value >> shift_of(piece)) & 0xf;
+  }
+
+  constexpr material_key flipped() const
+  {
+    return material_key(((value & low_nibbles) << 4)
+                        | ((value >> 4) & low_nibbles));
+  }
+
+  constexpr uint64_t get_value() const
+  {
+    return value;
+  }
+
+  constexpr bool operator== (material_key other) const
+  {
+    return value == other.value;
+  }
+
+private:
+
+  uint64_t value;
+
+  static constexpr uint64_t low_nibbles = UINT64_C(0x0f0f0f0f0f0f0f0f);
+
+  constexpr explicit material_key(uint64_t raw): value(raw) {}
+
+  static constexpr unsigned shift_of(square piece)
+  {
+    return (unsigned(piece) - 2) * 4;
+  }
+
+  static constexpr uint64_t unit_of(square piece)
+  {
+    return (piece >= pawn) ? (uint64_t(1) << shift_of(piece)) : 0;
+  }
+
+}; /* class material_key */
+
+} /* namespace kator */
+
+#endif /* !defined(KATOR_CHESS_MATERIAL_KEY_H) */
@@ -4,6 +4,7 @@
 
 #include <cassert>
 #include <array>
+#include <cstdint>
 #include <cstring>
 
 #include "chess.h"
@@ -103,6 +104,11 @@ public:
 
   static constexpr move null();
 
+  /* Leaves the move uninitialized, for buffers written by the {{{
+     move generator, see generate_legal_moves in move_list.h
+  }}}*/
+  move();
+
 private:
 
   explicit constexpr move(sq_index ctor_from,
@@ -111,8 +117,6 @@ private:
                           unsigned char ctor_captured,
                           unsigned char ctor_move_type);
 
-  move();
-
 }; /* class move */
 
 constexpr piece move::result() const
@@ -265,7 +269,7 @@ constexpr short move::change_index(unsigned char result_piece,
 
 constexpr short move::change_index() const
 {
-  return change_index(move_type, result_piece, captured_piece);
+  return change_index(result_piece, captured_piece, move_type);
 }
 
 constexpr short move::change_index(piece result_piece,
@@ -309,6 +313,137 @@ black_castle_queenside(e8, c8, piece::king, move::castle_queenside);
 constexpr move
 black_castle_kingside(e8, g8, piece::king, move::castle_kingside);
 
+/* A move packed into 16 bits, for the hash table and the killer slots. {{{
+   Six bits each for the from and to squares, two bits for the piece
+   promoted to, and two flag bits marking the special moves that can not
+   be deduced from the squares alone. Everything else -- the piece moving,
+   the piece captured, whether it is a double pawn push -- is read from
+   the position the move belongs to, see position::unpack.
+   The null packed_move is all zero, i.e. from a8 to a8, which is never
+   a valid move.
+}}}*/
+class packed_move
+{
+public:
+
+  enum flag_enum : unsigned {
+    normal = 0,
+    promotion = 1,
+    en_passant = 2,
+    castle = 3
+  };
+
+  constexpr packed_move(): value(0) {}
+  explicit constexpr packed_move(move);
+
+  static constexpr packed_move null();
+  static constexpr packed_move from_uint(unsigned);
+  constexpr unsigned to_uint() const;
+
+  constexpr sq_index from() const;
+  constexpr sq_index to() const;
+  constexpr flag_enum flags() const;
+  constexpr piece promotion_piece() const;
+  constexpr bool is_null() const;
+  constexpr bool operator== (const packed_move&) const;
+  constexpr bool operator!= (const packed_move&) const;
+
+  static constexpr unsigned bits = 16;
+
+private:
+
+  uint16_t value;
+
+  static constexpr unsigned to_shift = 6;
+  static constexpr unsigned promotion_shift = 12;
+  static constexpr unsigned flags_shift = 14;
+
+  explicit constexpr packed_move(uint16_t raw): value(raw) {}
+
+  static constexpr unsigned encode_promotion(piece);
+  static constexpr flag_enum encode_flags(move);
+
+}; /* class packed_move */
+
+constexpr unsigned packed_move::encode_promotion(piece promotion)
+{
+  return (promotion == piece::bishop) ? 1
+       : (promotion == piece::rook) ? 2
+       : (promotion == piece::queen) ? 3
+       : 0;
+}
+
+constexpr packed_move::flag_enum packed_move::encode_flags(move move)
+{
+  return move.is_promotion() ? promotion
+       : move.is_en_passant() ? en_passant
+       : (move.is_castle_kingside() or move.is_castle_queenside()) ? castle
+       : normal;
+}
+
+constexpr packed_move::packed_move(move move):
+  value(static_cast<uint16_t>(
+        move.from.offset()
+        | (move.to.offset() << to_shift)
+        | ((move.is_promotion() ? encode_promotion(move.result()) : 0)
+           << promotion_shift)
+        | (encode_flags(move) << flags_shift)))
+{
+}
+
+constexpr packed_move packed_move::null()
+{
+  return packed_move();
+}
+
+constexpr packed_move packed_move::from_uint(unsigned raw)
+{
+  return packed_move(static_cast<uint16_t>(raw));
+}
+
+constexpr unsigned packed_move::to_uint() const
+{
+  return value;
+}
+
+constexpr sq_index packed_move::from() const
+{
+  return sq_index(value & 0x3fu);
+}
+
+constexpr sq_index packed_move::to() const
+{
+  return sq_index((value >> to_shift) & 0x3fu);
+}
+
+constexpr packed_move::flag_enum packed_move::flags() const
+{
+  return static_cast<flag_enum>(value >> flags_shift);
+}
+
+constexpr piece packed_move::promotion_piece() const
+{
+  return (((value >> promotion_shift) & 3) == 0) ? piece::knight
+       : (((value >> promotion_shift) & 3) == 1) ? piece::bishop
+       : (((value >> promotion_shift) & 3) == 2) ? piece::rook
+       : piece::queen;
+}
+
+constexpr bool packed_move::is_null() const
+{
+  return value == 0;
+}
+
+constexpr bool packed_move::operator== (const packed_move& other) const
+{
+  return value == other.value;
+}
+
+constexpr bool packed_move::operator!= (const packed_move& other) const
+{
+  return value != other.value;
+}
+
 } /* namespace kator */
 
 #endif /* !defined(KATOR_CHESS_MOVE_H) */
@@ -8,37 +8,90 @@ namespace kator
 namespace
 {
 
+/* The check state of the position to generate moves for, {{{
+   decided once before generation starts, so each specialized
+   move_generator is free of the runtime branches on it.
+   In a double check only king moves are possible, in a single check
+   only moves resolving the check, and pinned pieces can not move at all.
+}}}*/
+enum class check_state
+{
+  none,
+  single_check,
+  double_check
+};
+
+/* The generator either writes the moves it finds to an array, {{{
+   or -- with count_only set -- just counts them. In the latter case
+   the moves of a piece are counted using the popcount of their
+   destination bitboard, only special moves are counted one by one.
+}}}*/
+template<move_generation type, check_state state, bool count_only>
 class move_generator
 {
 private:
 
+  static constexpr bool gen_captures =
+    (type != move_generation::quiets and type != move_generation::quiet_checks);
+  static constexpr bool gen_quiets = (type != move_generation::captures);
+  static constexpr bool is_in_check = (state != check_state::none);
+  static constexpr bool only_checks =
+    (type == move_generation::quiet_checks);
+
   move* pmove;
+  move* const moves_begin;
+  size_t move_count;
   bitboard nonpinned;
   bool ep_special_pin;
+  bitboard victims;
   bitboard dest_mask;
   const kator::position& position;
 
-public:
+  /* Used only while generating quiet checks: {{{
+     the squares each piece type would give check from, and the pieces
+     of the player to move standing alone in the way of one of its
+     own sliders towards the opponent's king.
+  }}}*/
+  bitboard knight_checks;
+  bitboard pawn_checks;
+  bitboard bishop_checks;
+  bitboard rook_checks;
+  bitboard discoverers;
 
-  move_generator(const kator::position& ctor_position, move* pm):
-    pmove(pm),
-    nonpinned(bitboard::universe()),
-    dest_mask(compl ctor_position.map_of(player_to_move)),
-    position(ctor_position)
-  { }
+  static bitboard
+  target_squares(const kator::position& position, bitboard victims)
+  {
+    bitboard result = bitboard::empty();
+
+    if (gen_captures) {
+      result.merge(intersection_of(position.map_of(player_opponent), victims));
+    }
+    if (gen_quiets) {
+      result.merge(compl position.occupied());
+    }
+    if (is_in_check) {
+      result.filter_by(position.king_attack_map());
+    }
+    return result;
+  }
+
+public:
 
   move_generator(const kator::position& ctor_position,
                  move* pm,
-                 bitboard victims):
+                 bitboard ctor_victims):
     pmove(pm),
+    moves_begin(pm),
+    move_count(0),
     nonpinned(bitboard::universe()),
-    dest_mask(victims),
+    ep_special_pin(false),
+    victims(ctor_victims),
+    dest_mask(target_squares(ctor_position, ctor_victims)),
     position(ctor_position)
-  { }
-
-  const move* current_pointer() const
   {
-    return pmove;
+    if (only_checks) {
+      setup_check_squares();
+    }
   }
 
 private:
@@ -48,14 +101,14 @@ private:
     return position.occupied();
   }
 
-  template<typename type>
-  bitboard map(type item) const
+  template<typename item_type>
+  bitboard map(item_type item) const
   {
     return position.map_of(item);
   }
 
-  template<typename type, typename... types>
-  bitboard map(type arg, types... tail) const
+  template<typename item_type, typename... types>
+  bitboard map(item_type arg, types... tail) const
   {
     return union_of(map(arg), map(tail...));
   }
@@ -65,37 +118,174 @@ private:
     return position.piece_at(index);
   }
 
+  void setup_check_squares()
+  {
+    sq_index king_i = position.opponent_king_index();
+
+    knight_checks = bitboard::knight_attacks(king_i);
+    pawn_checks = bitboard::opponent_pawn_attacks(bitboard(king_i));
+    bishop_checks = bitboard::bishop_attacks(occupied(), king_i);
+    rook_checks = bitboard::rook_attacks(occupied(), king_i);
+
+    bitboard snipers = union_of(
+        intersection_of(position.bishop_queen_map(),
+                        bitboard::bishop_pattern(king_i)),
+        intersection_of(position.rook_queen_map(),
+                        bitboard::rook_pattern(king_i)));
+
+    discoverers = bitboard::empty();
+    for (auto sniper_i : snipers) {
+      bitboard blockers = intersection_of(
+          bitboard::ray_between(king_i, sniper_i), occupied());
+
+      if (blockers.is_singular()
+          and not are_disjoint(blockers, map(player_to_move)))
+      {
+        discoverers.merge(blockers);
+      }
+    }
+  }
+
+  bitboard direct_checks(piece p) const
+  {
+    switch (p) {
+      case piece::knight:
+        return knight_checks;
+      case piece::bishop:
+        return bishop_checks;
+      case piece::rook:
+        return rook_checks;
+      case piece::queen:
+        return union_of(bishop_checks, rook_checks);
+      default:
+        return bitboard::empty();
+    }
+  }
+
+  bool is_on_discovery_line(sq_index from, sq_index to) const
+  {
+    /* A discoverer moving along the line between the king and {{{
+       the slider behind it ( either towards the king, or away
+       from it ) still blocks that line.
+    }}}*/
+    sq_index king_i = position.opponent_king_index();
+
+    return bitboard::ray_between(king_i, from).is_bit_set(to)
+           or bitboard::ray_between(king_i, to).is_bit_set(from);
+  }
+
+  bitboard discovering_moves(sq_index from, bitboard to_map) const
+  {
+    bitboard result = bitboard::empty();
+
+    if (discoverers.is_bit_set(from)) {
+      for (auto to : to_map) {
+        if (not is_on_discovery_line(from, to)) {
+          result.set_bit(to);
+        }
+      }
+    }
+    return result;
+  }
+
+  bitboard checking_moves(sq_index from, bitboard to_map,
+                          bitboard direct) const
+  {
+    return union_of(intersection_of(to_map, direct),
+                    discovering_moves(from, to_map));
+  }
+
+  bool is_checking_push(sq_index from, sq_index to) const
+  {
+    return (not only_checks)
+           or checking_moves(from, bitboard(to), pawn_checks).is_nonempty();
+  }
+
+  static size_t popcount(bitboard moves)
+  {
+    return static_cast<size_t>(moves.popcnt());
+  }
+
+  void add(move m)
+  {
+    if (count_only) {
+      ++move_count;
+    }
+    else {
+      *pmove++ = m;
+    }
+  }
+
   void add_simple_move(sq_index from, sq_index to, piece result)
   {
-    *pmove++ = move(from, to, result);
+    add(move(from, to, result));
   }
 
   void add_simple_move(sq_index from, sq_index to,
                        piece result, piece captured)
   {
-    *pmove++ = move(from, to, result, captured, move::general);
+    add(move(from, to, result, captured, move::general));
   }
 
   void add_promotions(sq_index from, sq_index to)
   {
-    *pmove++ = move(from, to, piece::queen, move::promotion);
-    *pmove++ = move(from, to, piece::knight, move::promotion);
-    *pmove++ = move(from, to, piece::bishop, move::promotion);
-    *pmove++ = move(from, to, piece::rook, move::promotion);
+    add(move(from, to, piece::queen, move::promotion));
+    add(move(from, to, piece::knight, move::promotion));
+    add(move(from, to, piece::bishop, move::promotion));
+    add(move(from, to, piece::rook, move::promotion));
   }
 
   void add_promotions(sq_index from, sq_index to, piece captured)
   {
-    *pmove++ = move(from, to, piece::queen, captured, move::promotion);
-    *pmove++ = move(from, to, piece::knight, captured, move::promotion);
-    *pmove++ = move(from, to, piece::bishop, captured, move::promotion);
-    *pmove++ = move(from, to, piece::rook, captured, move::promotion);
+    add(move(from, to, piece::queen, captured, move::promotion));
+    add(move(from, to, piece::knight, captured, move::promotion));
+    add(move(from, to, piece::bishop, captured, move::promotion));
+    add(move(from, to, piece::rook, captured, move::promotion));
+  }
+
+  void count_pawn_moves(bitboard to_map)
+  {
+    /* Each pawn move reaching the last rank is four promotions */
+    move_count += popcount(to_map)
+                  + 3 * popcount(intersection_of(to_map, bitboard(rank_8)));
+  }
+
+  void add_checking_promotions(sq_index from, sq_index to)
+  {
+    sq_index king_i = position.opponent_king_index();
+    bool is_discovery = discoverers.is_bit_set(from)
+                        and not is_on_discovery_line(from, to);
+    bitboard occ = occupied();
+
+    occ.reset_bit(from);
+    occ.set_bit(to);
+
+    bool diagonal = bitboard::bishop_attacks(occ, to).is_bit_set(king_i);
+    bool straight = bitboard::rook_attacks(occ, to).is_bit_set(king_i);
+
+    if (is_discovery or diagonal or straight) {
+      add(move(from, to, piece::queen, move::promotion));
+    }
+    if (is_discovery or knight_checks.is_bit_set(to)) {
+      add(move(from, to, piece::knight, move::promotion));
+    }
+    if (is_discovery or diagonal) {
+      add(move(from, to, piece::bishop, move::promotion));
+    }
+    if (is_discovery or straight) {
+      add(move(from, to, piece::rook, move::promotion));
+    }
   }
 
   void add_pawn_push(sq_index from, sq_index to)
   {
     if (to.rank() == rank_8) {
-      add_promotions(from, to);
+      if (only_checks) {
+        add_checking_promotions(from, to);
+      }
+      else {
+        add_promotions(from, to);
+      }
     }
     else {
       add_simple_move(from, to, piece::pawn);
@@ -114,7 +304,7 @@ private:
 
   void add_pawn_double_push(sq_index from, sq_index to)
   {
-    *pmove++ = move(from, to, piece::pawn, move::pawn_double_push);
+    add(move(from, to, piece::pawn, move::pawn_double_push));
   }
 
   void add_pawn_double_push(sq_index from)
@@ -136,9 +326,9 @@ private:
 
   void add_en_passant(sq_index from)
   {
-    *pmove++ = move(from, north_of(position.ep_index()),
-                    piece::pawn, piece::pawn,
-                    move::en_passant);
+    add(move(from, north_of(position.ep_index()),
+             piece::pawn, piece::pawn,
+             move::en_passant));
   }
 
   void add_general_move(sq_index from, sq_index to, piece result)
@@ -148,6 +338,10 @@ private:
 
   void add_general_moves(sq_index from, bitboard to_map, piece result)
   {
+    if (count_only) {
+      move_count += popcount(to_map);
+      return;
+    }
     for (auto to : to_map) {
       add_general_move(from, to, result);
     }
@@ -155,6 +349,11 @@ private:
 
   void add_general_moves(sq_index from, bitboard to_map)
   {
+    if (count_only) {
+      move_count += popcount(to_map);
+      return;
+    }
+
     piece result = piece_at(from);
 
     for (auto to : to_map) {
@@ -164,12 +363,12 @@ private:
 
   void add_castle_kingside()
   {
-    *pmove++ = castle_kingside;
+    add(castle_kingside);
   }
 
   void add_castle_queenside()
   {
-    *pmove++ = castle_queenside;
+    add(castle_queenside);
   }
 
   bool is_pin(bitboard ray) const
@@ -179,19 +378,24 @@ private:
   }
 
   void handle_pawn_pinned_by_bishop(bitboard ray,
-                                          sq_index pinned_i,
-                                          sq_index pinner_i)
+                                    sq_index pinned_i,
+                                    sq_index pinner_i)
   {
+    if (not gen_captures) {
+      return;
+    }
     if (pinner_i == north_of(left_of(pinned_i)) or
         pinner_i == north_of(right_of(pinned_i)))
     {
-      add_pawn_capture(pinned_i, pinner_i);
+      if (victims.is_bit_set(pinner_i)) {
+        add_pawn_capture(pinned_i, pinner_i);
+      }
     }
     else if (position.has_en_passant_square()) {
       sq_index epi = position.ep_index();
 
       if (right_of(pinned_i) == epi or left_of(pinned_i) == epi) {
-        if (ray.is_bit_set(north_of(epi))) {
+        if (ray.is_bit_set(north_of(epi)) and victims.is_bit_set(epi)) {
           add_en_passant(pinned_i);
         }
       }
@@ -200,10 +404,17 @@ private:
 
   void handle_pawn_pinned_by_rook(bitboard ray, sq_index pinned_i)
   {
+    if (not gen_quiets) {
+      return;
+    }
     if (ray.is_bit_set(north_of(pinned_i))) {
-      add_pawn_push_strict(pinned_i);
+      if (is_checking_push(pinned_i, north_of(pinned_i))) {
+        add_pawn_push_strict(pinned_i);
+      }
       if (pinned_i.rank() == rank_2) {
-        if (ray.is_bit_set(north_of(north_of(pinned_i)))) {
+        sq_index to = north_of(north_of(pinned_i));
+
+        if (ray.is_bit_set(to) and is_checking_push(pinned_i, to)) {
           add_pawn_double_push(pinned_i);
         }
       }
@@ -237,7 +448,7 @@ private:
   void handle_pinned_by(bitboard ray, sq_index pinner_i)
   {
     nonpinned = intersection_of(nonpinned, compl ray);
-    if (position.in_check()) {
+    if (is_in_check) {
       return;
     }
     sq_index pinned_i =
@@ -246,6 +457,10 @@ private:
     if (not are_disjoint(sliders<is_bishop>(position), ray)) {
       ray.set_bit(pinner_i);
       ray.reset_bit(pinned_i);
+      ray.filter_by(dest_mask);
+      if (only_checks) {
+        ray = checking_moves(pinned_i, ray, direct_checks(piece_at(pinned_i)));
+      }
       add_general_moves(pinned_i, ray);
     }
     else if (not are_disjoint(map(pawn), ray)) {
@@ -311,11 +526,35 @@ private:
     }
   }
 
+  bool does_castle_give_check(sq_index king_to,
+                              sq_index rook_from,
+                              sq_index rook_to) const
+  {
+    /* Either the rook checks from its new square, or the {{{
+       king leaving e1 uncovers a line from another slider
+    }}}*/
+    sq_index king_i = position.opponent_king_index();
+    bitboard occ = occupied();
+    bitboard rooks = position.rook_queen_map();
+
+    occ.reset_bit(position.king_index());
+    occ.reset_bit(rook_from);
+    occ.set_bit(king_to);
+    occ.set_bit(rook_to);
+    rooks.reset_bit(rook_from);
+    rooks.set_bit(rook_to);
+
+    return not are_disjoint(bitboard::rook_attacks(occ, king_i), rooks)
+           or not are_disjoint(bitboard::bishop_attacks(occ, king_i),
+                               position.bishop_queen_map());
+  }
+
   void gen_castle_kingside()
   {
     if (position.can_castle_kingside()
         and position.is_any_unoccupied(f1, g1)
-        and not position.is_any_attacked_by(player_opponent, f1, g1))
+        and not position.is_any_attacked_by(player_opponent, f1, g1)
+        and (not only_checks or does_castle_give_check(g1, h1, f1)))
     {
       add_castle_kingside();
     }
@@ -325,17 +564,33 @@ private:
   {
     if (position.can_castle_queenside()
         and position.is_any_unoccupied(b1, c1, d1)
-        and not position.is_any_attacked_by(player_opponent, c1, d1))
+        and not position.is_any_attacked_by(player_opponent, c1, d1)
+        and (not only_checks or does_castle_give_check(c1, a1, d1)))
     {
       add_castle_queenside();
     }
   }
 
+  bool does_en_passant_resolve_check()
+  {
+    /* Either the pawn just pushed is the checker, or the pawn {{{
+       capturing en passant blocks a check from a slider
+    }}}*/
+    sq_index victim = position.ep_index();
+
+    return position.king_attack_map().is_bit_set(victim)
+           or position.king_attack_map().is_bit_set(north_of(victim));
+  }
+
   bool can_en_passant_at_all()
   {
-    return position.has_en_passant_square()
-           and not ep_special_pin
-           and dest_mask.is_bit_set(north_of(position.ep_index()));
+    if (not position.has_en_passant_square() or ep_special_pin) {
+      return false;
+    }
+    if (not victims.is_bit_set(position.ep_index())) {
+      return false;
+    }
+    return (not is_in_check) or does_en_passant_resolve_check();
   }
 
   bool can_en_passant_from_left()
@@ -370,6 +625,9 @@ private:
       bitboard to_map = bitboard::knight_attacks(from);
 
       to_map.filter_by(dest_mask);
+      if (only_checks) {
+        to_map = checking_moves(from, to_map, knight_checks);
+      }
       add_general_moves(from, to_map, piece::knight);
     }
   }
@@ -378,13 +636,40 @@ private:
   {
     bitboard pawns = intersection_of(map(pawn), nonpinned);
     bitboard pushes = intersection_of(north_of(pawns), compl occupied());
+    bitboard single_mask = dest_mask;
+    bitboard double_mask = dest_mask;
+
+    if (only_checks) {
+      /* A discoverer pawn leaves the line it blocks with any push, {{{
+         unless that line is the file of the opponent's king.
+         Promotions are checked one by one, per promoted piece.
+      }}}*/
+      file king_file = position.opponent_king_index().file();
+      bitboard discovering = intersection_of(pawns, discoverers,
+                                             compl bitboard(king_file));
+
+      single_mask.filter_by(union_of(pawn_checks,
+                                     north_of(discovering),
+                                     bitboard(rank_8)));
+      double_mask.filter_by(union_of(pawn_checks,
+                                     north_of(north_of(discovering))));
+    }
 
-    for (auto push : intersection_of(pushes, dest_mask)) {
-      add_pawn_push(south_of(push), push);
+    if (count_only and not only_checks) {
+      count_pawn_moves(intersection_of(pushes, single_mask));
+    }
+    else {
+      for (auto push : intersection_of(pushes, single_mask)) {
+        add_pawn_push(south_of(push), push);
+      }
     }
     pushes = north_of(pushes);
-    pushes.filter_by(bitboard(rank_4), compl occupied());
-    for (auto push : intersection_of(pushes, dest_mask)) {
+    pushes.filter_by(bitboard(rank_4), compl occupied(), double_mask);
+    if (count_only) {
+      move_count += popcount(pushes);
+      return;
+    }
+    for (auto push : pushes) {
       add_pawn_double_push(south_of(south_of(push)), push);
     }
   }
@@ -395,13 +680,23 @@ private:
     bitboard attacks = bitboard::pawn_attacks_left(pawns);
 
     attacks = intersection_of(attacks, map(player_opponent), dest_mask);
-    for (auto to : attacks) {
-      add_pawn_capture(right_of(south_of(to)), to);
+    if (count_only) {
+      count_pawn_moves(attacks);
+    }
+    else {
+      for (auto to : attacks) {
+        add_pawn_capture(right_of(south_of(to)), to);
+      }
     }
     attacks = bitboard::pawn_attacks_right(pawns);
     attacks = intersection_of(attacks, map(player_opponent), dest_mask);
-    for (auto to : intersection_of(attacks, map(player_opponent))) {
-      add_pawn_capture(left_of(south_of(to)), to);
+    if (count_only) {
+      count_pawn_moves(attacks);
+    }
+    else {
+      for (auto to : attacks) {
+        add_pawn_capture(left_of(south_of(to)), to);
+      }
     }
   }
 
@@ -410,90 +705,199 @@ private:
     for (auto from : intersection_of(pieces, nonpinned)) {
       bitboard to_map = bitboard::sliding_attacks(magics, occupied(), from);
 
-      add_general_moves(from, intersection_of(to_map, dest_mask));
+      to_map.filter_by(dest_mask);
+      if (only_checks) {
+        to_map = checking_moves(from, to_map, direct_checks(piece_at(from)));
+      }
+      add_general_moves(from, to_map);
+    }
+  }
+
+  bool might_reach_targets(unsigned piece) const
+  {
+    /* The attack map of each piece type is already available in {{{
+       the position, which makes it cheap to skip looping over
+       the pieces of a type that can't capture anything anyways.
+    }}}*/
+    if (type != move_generation::captures) {
+      return true;
     }
+    return not are_disjoint(position.attacks_of(piece), dest_mask);
   }
 
   void gen_king_moves()
   {
-    bitboard to_map = intersection_of(
-                        bitboard::king_attacks(position.king_index()),
-                        compl map(player_to_move),
-                        compl position.attacks_of(player_opponent));
+    bitboard to_map = bitboard::empty();
+
+    if (gen_captures) {
+      to_map.merge(intersection_of(map(player_opponent), victims));
+    }
+    if (gen_quiets) {
+      to_map.merge(compl occupied());
+    }
+    to_map.filter_by(bitboard::king_attacks(position.king_index()),
+                     compl position.attacks_of(player_opponent));
+    if (only_checks) {
+      to_map = discovering_moves(position.king_index(), to_map);
+    }
 
     add_general_moves(position.king_index(), to_map, piece::king);
   }
 
 public:
 
-  void run()
+  /* Returns the number of moves found */
+  size_t run()
   {
-    if (not position.has_multiple_checkers()) {
-      ep_special_pin = false;
-
+    if (state != check_state::double_check) {
       handle_bishop_pins();
       handle_rook_pins();
-      if (position.in_check()) {
-        dest_mask.filter_by(position.king_attack_map());
-      }
-      else {
+      if (not is_in_check and gen_quiets) {
         gen_castle_kingside();
         gen_castle_queenside();
       }
-      gen_en_passant();
-      gen_knight_moves();
-      gen_pawn_pushes();
-      gen_pawn_captures();
-      gen_sliding_moves(bitboard::magical::rook, map(rook, queen));
-      gen_sliding_moves(bitboard::magical::bishop, map(bishop, queen));
+      if (gen_captures) {
+        gen_en_passant();
+      }
+      if (might_reach_targets(knight)) {
+        gen_knight_moves();
+      }
+      if (gen_quiets) {
+        gen_pawn_pushes();
+      }
+      if (gen_captures) {
+        gen_pawn_captures();
+      }
+      if (might_reach_targets(rook) or might_reach_targets(queen)) {
+        gen_sliding_moves(bitboard::magical::rook, map(rook, queen));
+      }
+      if (might_reach_targets(bishop) or might_reach_targets(queen)) {
+        gen_sliding_moves(bitboard::magical::bishop, map(bishop, queen));
+      }
     }
     gen_king_moves();
+    if (count_only) {
+      return move_count;
+    }
+    else {
+      return static_cast<size_t>(pmove - moves_begin);
+    }
   }
 
-  void run_captures()
-  {
-    assert(not position.in_check());
+}; /* template class move_generator */
 
-    ep_special_pin = false;
-    handle_bishop_pins();
-    handle_rook_pins();
+template<move_generation type, bool count_only = false>
+size_t generate_moves(const position& position, move* moves, bitboard victims)
+{
+  assert(type != move_generation::evasions or position.in_check());
 
-    if (not are_disjoint(dest_mask, map(opponent_pawn))) {
-      gen_en_passant();
-    }
-    gen_knight_moves();
-    gen_pawn_captures();
-    if (intersection_of(position.attacks_of(rook), dest_mask).is_nonempty()) {
-      gen_sliding_moves(bitboard::magical::rook, map(rook));
-    }
-    if (intersection_of(position.attacks_of(queen), dest_mask).is_nonempty()) {
-      gen_sliding_moves(bitboard::magical::rook, map(rook));
-      gen_sliding_moves(bitboard::magical::bishop, map(queen));
-    }
-    if (intersection_of(position.attacks_of(bishop), dest_mask).is_nonempty()) {
-      gen_sliding_moves(bitboard::magical::bishop, map(bishop));
-    }
-    gen_king_moves();
+  if (position.has_multiple_checkers()) {
+    return move_generator<type, check_state::double_check, count_only>
+             (position, moves, victims).run();
+  }
+  else if (type == move_generation::evasions or position.in_check()) {
+    return move_generator<type, check_state::single_check, count_only>
+             (position, moves, victims).run();
+  }
+  else {
+    return move_generator<type, check_state::none, count_only>
+             (position, moves, victims).run();
   }
+}
 
-}; /* inline class move_generator */
+/* Constructors can not be multiversioned, the move_list {{{
+   constructors delegate to this function instead.
+}}}*/
+KATOR_MULTIVERSION
+size_t generate_moves(const position& position,
+                      move_generation type,
+                      move* moves,
+                      bitboard victims)
+{
+  switch (type) {
+    case move_generation::all:
+      break;
+    case move_generation::captures:
+      return generate_moves<move_generation::captures>(position, moves,
+                                                       victims);
+    case move_generation::quiets:
+      return generate_moves<move_generation::quiets>(position, moves,
+                                                     victims);
+    case move_generation::evasions:
+      return generate_moves<move_generation::evasions>(position, moves,
+                                                       victims);
+    case move_generation::quiet_checks:
+      return generate_moves<move_generation::quiet_checks>(position, moves,
+                                                           victims);
+  }
+  return generate_moves<move_generation::all>(position, moves, victims);
+}
 
 } /* anonym namespace */
 
 move_list::move_list(const position& position)
 {
-  move_generator generator(position, moves);
+  size = generate_moves(position, move_generation::all, moves,
+                        bitboard::universe());
+}
 
-  generator.run();
-  size = static_cast<size_t>(generator.current_pointer() - moves);
+move_list::move_list(const position& position, move_generation type)
+{
+  size = generate_moves(position, type, moves, bitboard::universe());
 }
 
 move_list::move_list(const position& position, bitboard victims)
 {
-  move_generator generator(position, moves, victims);
+  size = generate_moves(position, move_generation::captures, moves, victims);
+}
 
-  generator.run();
-  size = static_cast<size_t>(generator.current_pointer() - moves);
+size_t generate_legal_moves(const position& position,
+                            move* buffer,
+                            size_t capacity)
+{
+  (void)capacity;
+  ASSUME(capacity >= move_list::max_size);
+  return generate_moves(position, move_generation::all, buffer,
+                        bitboard::universe());
+}
+
+size_t generate_legal_moves(const position& position,
+                            move_generation type,
+                            move* buffer,
+                            size_t capacity)
+{
+  (void)capacity;
+  ASSUME(capacity >= move_list::max_size);
+  return generate_moves(position, type, buffer, bitboard::universe());
+}
+
+KATOR_MULTIVERSION
+size_t count_legal_moves(const position& position)
+{
+  return generate_moves<move_generation::all, true>(position, nullptr,
+                                                    bitboard::universe());
+}
+
+KATOR_MULTIVERSION
+size_t count_legal_moves(const position& position, move_generation type)
+{
+  switch (type) {
+    case move_generation::all:
+      break;
+    case move_generation::captures:
+      return generate_moves<move_generation::captures, true>
+               (position, nullptr, bitboard::universe());
+    case move_generation::quiets:
+      return generate_moves<move_generation::quiets, true>
+               (position, nullptr, bitboard::universe());
+    case move_generation::evasions:
+      return generate_moves<move_generation::evasions, true>
+               (position, nullptr, bitboard::universe());
+    case move_generation::quiet_checks:
+      return generate_moves<move_generation::quiet_checks, true>
+               (position, nullptr, bitboard::universe());
+  }
+  return count_legal_moves(position);
 }
 
 size_t move_list::count() const noexcept
@@ -11,10 +11,41 @@ namespace engine
 class node;
 }
 
+/* The subsets of legal moves the move generator can produce. {{{
+   Captures and quiets are complementary, their union is the set of
+   all legal moves ( promotions without capture are quiets, en passant
+   is a capture ). Evasions can only be requested in a position where
+   the king is in check, and in that case are the same as all moves.
+   Quiet checks are the subset of quiets giving check, either directly,
+   or by uncovering a line from a slider to the opponent's king -- as
+   needed at the first plies of a quiescence search, or a mate search.
+}}}*/
+enum class move_generation
+{
+  all,
+  captures,
+  quiets,
+  evasions,
+  quiet_checks
+};
+
+/* Counting the legal moves, without writing them anywhere. {{{
+   Cheaper than constructing a move_list, meant for the leaves
+   of perft, and for mobility evaluation.
+}}}*/
+size_t count_legal_moves(const position&);
+size_t count_legal_moves(const position&, move_generation);
+
 class move_list
 {
+public:
+
+  /* The most legal moves known to be possible in a position */
+  static constexpr size_t max_size = 219;
+
+private:
 
-  move moves[219];
+  move moves[max_size];
   size_t size;
 
 public:
@@ -41,6 +72,7 @@ public:
   }
 
   move_list(const position&);
+  move_list(const position&, move_generation);
   move_list(const position&, bitboard capture_targets);
   move_list(const position&, real_player player_to_move);
   size_t count() const noexcept;
@@ -64,6 +96,34 @@ protected:
   friend engine::node;
 }; /* class move_list */
 
+/* Generating the legal moves into a buffer supplied by the caller, {{{
+   returning the number of moves written. The capacity of the buffer
+   must be at least move_list::max_size moves -- checked at compile
+   time for arrays. Nothing is copied, the buffer can be a local array,
+   or part of some longer lived structure.
+}}}*/
+size_t generate_legal_moves(const position&, move* buffer, size_t capacity);
+size_t generate_legal_moves(const position&, move_generation,
+                            move* buffer, size_t capacity);
+
+template<size_t capacity>
+size_t generate_legal_moves(const position& position,
+                            move (&buffer)[capacity])
+{
+  static_assert(capacity >= move_list::max_size,
+                "room for the moves of any position");
+  return generate_legal_moves(position, buffer, capacity);
+}
+
+template<size_t capacity>
+size_t generate_legal_moves(const position& position, move_generation type,
+                            move (&buffer)[capacity])
+{
+  static_assert(capacity >= move_list::max_size,
+                "room for the moves of any position");
+  return generate_legal_moves(position, type, buffer, capacity);
+}
+
 } /* namespace kator */
 
 #endif /* !defined(KATOR_MOVE_LIST_H) */
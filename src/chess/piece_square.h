@@ -0,0 +1,134 @@
+
+#ifndef KATOR_CHESS_PIECE_SQUARE_H
+#define KATOR_CHESS_PIECE_SQUARE_H
+
+#include <array>
+#include <cstdint>
+
+#include "chess.h"
+
+namespace kator
+{
+
+/* The sum of piece-square values on a board, for the opening / {{{
+   middlegame, and the endgame. Each position keeps a running sum,
+   updated during make_move along with the hash keys, from the point
+   of view of the player to move.
+   The two values are packed into the two 16 bit halves of one integer
+   -- the endgame value in the upper half, borrowing from it when the
+   midgame value is negative -- so updating both at once is a single
+   addition. The two are only separated when interpolating between
+   them at the end of an evaluation.
+}}}*/
+class psq_score
+{
+public:
+
+  constexpr psq_score(): packed(0) {}
+
+  constexpr psq_score(int midgame, int endgame):
+    packed(static_cast<int32_t>(static_cast<uint32_t>(endgame) << 16)
+           + midgame)
+  {
+  }
+
+  constexpr int midgame() const
+  {
+    return static_cast<int16_t>(static_cast<uint16_t>(packed));
+  }
+
+  constexpr int endgame() const
+  {
+    return static_cast<int16_t>(static_cast<uint16_t>(
+             (static_cast<uint32_t>(packed) + 0x8000) >> 16));
+  }
+
+  constexpr psq_score operator- () const
+  {
+    return psq_score(wrapped(0u - static_cast<uint32_t>(packed)));
+  }
+
+  constexpr psq_score operator+ (psq_score other) const
+  {
+    return psq_score(wrapped(static_cast<uint32_t>(packed)
+                             + static_cast<uint32_t>(other.packed)));
+  }
+
+  constexpr psq_score operator- (psq_score other) const
+  {
+    return psq_score(wrapped(static_cast<uint32_t>(packed)
+                             - static_cast<uint32_t>(other.packed)));
+  }
+
+  constexpr psq_score operator* (int factor) const
+  {
+    return psq_score(wrapped(static_cast<uint32_t>(packed)
+                             * static_cast<uint32_t>(factor)));
+  }
+
+  psq_score& operator+= (psq_score other)
+  {
+    return *this = *this + other;
+  }
+
+  psq_score& operator-= (psq_score other)
+  {
+    return *this = *this - other;
+  }
+
+  constexpr bool operator== (psq_score other) const
+  {
+    return packed == other.packed;
+  }
+
+  /* Interpolating by phase, between 0 ( endgame ) and max_phase */
+  constexpr int tapered(unsigned phase, unsigned max_phase) const
+  {
+    return (midgame() * int(phase) + endgame() * int(max_phase - phase))
+           / int(max_phase);
+  }
+
+private:
+
+  int32_t packed;
+
+  struct wrapped
+  {
+    uint32_t value;
+
+    constexpr explicit wrapped(uint32_t raw): value(raw) {}
+  };
+
+  constexpr explicit psq_score(wrapped raw):
+    packed(static_cast<int32_t>(raw.value))
+  {
+  }
+
+}; /* class psq_score */
+
+/* The game phase, counted in the non-pawn material left on the {{{
+   board, updated on captures and promotions. Starting at
+   max_game_phase, reaching zero with only kings and pawns left.
+   Promotions can push the phase above max_game_phase.
+}}}*/
+constexpr unsigned max_game_phase = 24;
+
+constexpr unsigned phase_weight(piece piece)
+{
+  return (piece == piece::knight or piece == piece::bishop) ? 1
+       : (piece == piece::rook) ? 2
+       : (piece == piece::queen) ? 4
+       : 0;
+}
+
+typedef std::array<std::array<psq_score, 64>, piece_array_size> psq_table;
+
+/* Indexed by square, and sq_index offset -- the entries of the {{{
+   opponent's pieces are the negated values of the flipped squares.
+   These are evaluation parameters, defined in engine/eval.cc.
+}}}*/
+extern const psq_table piece_square_table;
+
+} /* namespace kator */
+
+#endif /* !defined(KATOR_CHESS_PIECE_SQUARE_H) */
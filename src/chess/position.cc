@@ -6,23 +6,26 @@
 #include "position.h"
 #include "move.h"
 #include "castle_rights.h"
-#include "platform/x64_vectors.h"
+#include "copy_and_flip.h"
+#include "kogge_stone.h"
+#include "platform/block_pool.h"
 
 using ::std::string;
 
 namespace kator
 {
 
+static_assert(alignof(position) <= cache_line_size,
+              "the block pool only aligns to cache lines");
+
 void* position::operator new(std::size_t requested_size)
 {
-  return aligned_allocate(requested_size, alignof(position));
+  return block_pool_allocate(requested_size);
 }
 
-void position::operator delete(void* pointer)
+void position::operator delete(void* pointer, std::size_t size)
 {
-  if (pointer != nullptr) {
-    anligned_deallocate(pointer);
-  }
+  block_pool_deallocate(pointer, size);
 }
 
 
@@ -142,11 +145,13 @@ bool are_king_maps_sane(const position* position)
 
 void setup_zhash(const position* position, zobrist_hash_pair* zhash)
 {
-  /*  TODO
-  for (auto index : sq_index::range()) {
-    zhash->xor_piece(position.square_at(index), index);
+  *zhash = zobrist_hash_pair::initial();
+  for (auto index : position->occupied()) {
+    zhash->xor_piece(position->square_at(index), index);
+  }
+  if (position->has_en_passant_square()) {
+    zhash->xor_en_passant_file(position->ep_index().file());
   }
-  */
   if (position->can_castle_queenside()) {
     zhash->xor_castle_right(castle_rights::side::queenside);
   }
@@ -161,6 +166,49 @@ void setup_zhash(const position* position, zobrist_hash_pair* zhash)
   }
 }
 
+psq_score psq_sum_of(const position* position)
+{
+  psq_score sum;
+
+  for (auto index : position->occupied()) {
+    sum += piece_square_table[position->square_at(index)][index.offset()];
+  }
+  return sum;
+}
+
+pawn_hash pawn_zhash_of(const position* position)
+{
+  pawn_hash key;
+
+  for (auto index : position->map_of(pawn, opponent_pawn)) {
+    key.xor_piece(position->square_at(index), index);
+  }
+  return key;
+}
+
+unsigned game_phase_of(const position* position)
+{
+  unsigned sum = 0;
+
+  for (auto piece : all_piece_types()) {
+    bitboard pieces = position->map_of(make_square(piece, player_to_move),
+                                       make_square(piece, player_opponent));
+
+    sum += phase_weight(piece) * unsigned(pieces.popcnt());
+  }
+  return sum;
+}
+
+material_key material_key_of(const position* position)
+{
+  material_key key;
+
+  for (auto index : position->occupied()) {
+    key.add(position->square_at(index));
+  }
+  return key;
+}
+
 void update_player_maps(bitboard* RESTRICT dst, const bitboard* RESTRICT maps)
 {
   dst[0] = union_of(maps[2], maps[4], maps[6], maps[8], maps[10], maps[12]);
@@ -179,22 +227,30 @@ bitboard all_knight_attacks(bitboard knights)
 
 bitboard all_bishop_attacks(bitboard bishops, bitboard occupied)
 {
+#ifdef KATOR_USE_KOGGE_STONE_ATTACKS
+  return bishop_fill_attacks(bishops, occupied);
+#else
   bitboard accumulator = bitboard::empty();
 
   for (auto index : bishops) {
     accumulator.merge(bitboard::bishop_attacks(occupied, index));
   }
   return accumulator;
+#endif
 }
 
 bitboard all_rook_attacks(bitboard rooks, bitboard occupied)
 {
+#ifdef KATOR_USE_KOGGE_STONE_ATTACKS
+  return rook_fill_attacks(rooks, occupied);
+#else
   bitboard accumulator = bitboard::empty();
 
   for (auto index : rooks) {
     accumulator.merge(bitboard::rook_attacks(occupied, index));
   }
   return accumulator;
+#endif
 }
 
 bitboard ray_checkers(const position* position, bitboard bandits)
@@ -293,142 +349,42 @@ inline void position::generate_attack_maps()
   }
 }
 
-#ifdef KATOR_USE_BOARD_VECTOR_64
-#ifdef KATOR_HAS_X64_512BIT_BUILTINS
-
-#error not yet implemented
-
-static inline void vector_board_copy_and_flip(void* dst, const void* src)
-{
-  local_init_x64_vectors_64();
-
-  double* vdst = (double*)dst;
-  const double* vsrc = (double*)src;
-  __m512d temp;
-
-  temp = _mm512_load_pd(vsrc);
-  temp = _mm512_permutexvar_pd(temp, permutation_selector);
-  _mm512_store_pd(vdst);
-}
-
-#elif defined(KATOR_HAS_X64_256BIT_AVX2_BUILTINS)
-
-static inline void vector_board_copy_and_flip(void* dst, const void* src)
-{
-  //local_init_x64_vectors_32();
-
-  //constexpr uint8_t permutation_selector = 0 + (1 << 4) + (2 << 2) + (3 << 0);
-
-  double* RESTRICT vdst = (double*)dst;
-  const double* RESTRICT vsrc = (double*)src;
-  __m256d temp0, temp1;
-
-  temp0 = _mm256_load_pd(vsrc);
-  temp1 = _mm256_load_pd(vsrc + 4);
-  temp0 = _mm256_permute4x64_pd(temp0, 0 + (1 << 4) + (2 << 2) + (3 << 0));
-  temp1 = _mm256_permute4x64_pd(temp1, 0 + (1 << 4) + (2 << 2) + (3 << 0));
-  _mm256_store_pd(vdst + 4, temp0);
-  _mm256_store_pd(vdst, temp1);
-}
-
-#elif defined(KATOR_HAS_X64_256BIT_BUILTINS)
+#ifdef KATOR_USE_RUNTIME_DISPATCH
 
-static inline void vector_board_copy_and_flip(void* dst, const void* src)
+namespace
 {
-//  local_init_x64_vectors_32();
-
-  constexpr int permutation_selector = 1 + (1 << 2);
 
-  double* RESTRICT vdst = static_cast<double*>(dst);
-  const double* RESTRICT vsrc = static_cast<const double*>(src);
-  __m256d temp0, temp1;
+const copy_and_flip_implementation& flip_kernel = best_copy_and_flip();
 
-  temp0 = _mm256_load_pd(vsrc);
-  temp1 = _mm256_load_pd(vsrc + 4);
-  temp0 = _mm256_permute_pd(temp0, permutation_selector);
-  temp1 = _mm256_permute_pd(temp1, permutation_selector);
-  temp0 = _mm256_permute2f128_pd(temp0, temp0, 1);
-  temp1 = _mm256_permute2f128_pd(temp1, temp1, 1);
-  _mm256_store_pd(vdst + 4, temp0);
-  _mm256_store_pd(vdst, temp1);
 }
 
-#elif defined(KATOR_HAS_X64_128BIT_BUILTINS)
-// SSE2
-
-static inline void vector_board_copy_and_flip(void* dst, const void* src)
-{
-  constexpr int permutation_selector = 1 + (1 << 2);
-
-  double* RESTRICT vdst = static_cast<double*>(dst);
-  const double* RESTRICT vsrc = static_cast<const double*>(src);
-  __m128d temp0, temp1, temp2, temp3;
-
-  temp0 = _mm_load_pd(vsrc);
-  temp1 = _mm_load_pd(vsrc + 2);
-  temp2 = _mm_load_pd(vsrc + 4);
-  temp3 = _mm_load_pd(vsrc + 6);
-  _mm_storel_pd(vdst + 7, temp0);
-  _mm_storeh_pd(vdst + 6, temp0);
-  _mm_storel_pd(vdst + 5, temp1);
-  _mm_storeh_pd(vdst + 4, temp1);
-  _mm_storel_pd(vdst + 3, temp2);
-  _mm_storeh_pd(vdst + 2, temp2);
-  _mm_storel_pd(vdst + 1, temp3);
-  _mm_storeh_pd(vdst + 0, temp4);
-
-
-	/*
-  local_init_x64_vectors_16();
-
-  __m64* vdst = (__m64*)dst;
-  const __m128i* vsrc = (__m128i*)src;
-  __m128i temp0, temp1;
-
-  temp0 = _mm_xor_si128(vsrc[0], vector_16_one);
-  temp1 = _mm_cmpeq_epi8(vsrc[0], vector_16_zero);
-  temp1 = _mm_andnot_si128(temp1, temp0);
-  _mm_storel_p(vdst + 7, temp1);
-  _mm_storeh_pi(vdst + 6, temp1);
-  temp0 = _mm_xor_si128(vsrc[1], vector_16_one);
-  temp1 = _mm_cmpeq_epi8(vsrc[1], vector_16_zero);
-  temp1 = _mm_andnot_si128(temp1, temp0);
-  _mm_storel_pi(vdst + 5, temp1);
-  _mm_storeh_pi(vdst + 4, temp1);
-  temp0 = _mm_xor_si128(vsrc[2], vector_16_one);
-  temp1 = _mm_cmpeq_epi8(vsrc[2], vector_16_zero);
-  temp1 = _mm_andnot_si128(temp1, temp0);
-  _mm_storel_pi(vdst + 3, temp1);
-  _mm_storeh_pi(vdst + 2, temp1);
-  temp0 = _mm_xor_si128(vsrc[3], vector_16_one);
-  temp1 = _mm_cmpeq_epi8(vsrc[3], vector_16_zero);
-  temp1 = _mm_andnot_si128(temp1, temp0);
-  _mm_storel_pi(vdst + 1, temp1);
-  _mm_storeh_pi(vdst + 0, temp1);
-  */
-}
-
-#else
-#  error No compiler vector support found for use with piece board
-#endif
-
-#endif // KATOR_USE_BOARD_VECTOR_64
+#endif // KATOR_USE_RUNTIME_DISPATCH
 
 static inline void
 board_copy_and_flip(unsigned char* RESTRICT dst,
                     const unsigned char* RESTRICT src)
 {
-#ifdef KATOR_USE_BOARD_VECTOR_64
+#ifdef KATOR_USE_RUNTIME_DISPATCH
+
+  flip_kernel.board(dst, src);
 
-  vector_board_copy_and_flip(dst, src);
+#elif defined(KATOR_USE_BOARD_VECTOR_64)
+
+#  ifdef KATOR_HAS_X64_512BIT_AVX512BW_BUILTINS
+  avx512_board_copy_and_flip(dst, src);
+#  elif defined(KATOR_HAS_X64_256BIT_AVX2_BUILTINS)
+  avx2_board_copy_and_flip(dst, src);
+#  elif defined(KATOR_HAS_X64_128BIT_BUILTINS)
+  sse2_board_copy_and_flip(dst, src);
+#  else
+#    error No compiler vector support found for use with piece board
+#  endif
 
 #else
 
-  for (int i = 0; i < 64; i += 8) {
-    std::memcpy(dst + (56 - i), src + i, 8);
-  }
+  portable_board_copy_and_flip(dst, src);
 
-#endif // KATOR_USE_BOARD_VECTOR_64
+#endif
 }
 
 static inline bool
@@ -502,59 +458,12 @@ position::position(const std::array<real_square, 64>& ctor_board,
     throw invalid_castle_rights();
   }
   setup_zhash(this, zhash_pair());
+  *psq() = psq_sum_of(this);
+  *phase() = game_phase_of(this);
+  *pawn_zhash() = pawn_zhash_of(this);
+  *material() = material_key_of(this);
 }
 
-namespace
-{
-
-#ifdef KATOR_USE_PIECE_MAP_VECTOR
-#  ifdef KATOR_HAS_X64_512BIT_BUILTINS
-
-     void vector_piece_map_copy_and_flip(uint64_t* RESTRICT dst,
-                                         const uint64_t* RESTRICT src)
-     {
-       __m512i* src64 = (__m512i*)src;
-       __m512i* dst64 = (__m512i*)dst;
-
-       dst64[0] = _mm512_shuffle_epi8(src64[0], bswap_shuffle_key_64);
-       dst64[1] = _mm512_shuffle_epi8(src64[1], bswap_shuffle_key_64);
-     }
-
-
-#  elif defined(KATOR_HAS_X64_256BIT_AVX2_BUILTINS)
-
-     void vector_piece_map_copy_and_flip(uint64_t* RESTRICT dst,
-                                         const uint64_t* RESTRICT src)
-     {
-       __m256i* src32 = (__m256i*)src;
-       __m256i* dst32 = (__m256i*)dst;
-
-       dst32[0] = _mm256_shuffle_epi8(src32[0], bswap_shuffle_key_32);
-       dst32[1] = _mm256_shuffle_epi8(src32[1], bswap_shuffle_key_32);
-       dst32[2] = _mm256_shuffle_epi8(src32[2], bswap_shuffle_key_32);
-     }
-
-#  elif defined(KATOR_HAS_X64_128BIT_SSSE3_SHUFFLE_BUILTIN)
-
-     void vector_piece_map_copy_and_flip(uint64_t* RESTRICT dst,
-                                         const uint64_t* RESTRICT src)
-     {
-       __m128i* src16 = (__m128i*)src;
-       __m128i* dst16 = (__m128i*)dst;
-
-       for (size_t i = 0; i < 6; ++i) {
-         dst16[i] = _mm_shuffle_epi8(src16[i], bswap_shuffle_key_16);
-       }
-     }
-
-
-#  else
-#    error No compiler vector support found for use with piece_maps
-#  endif
-#endif // KATOR_USE_PIECE_MAP_VECTOR
-
-} /* anonym namespace */
-
 inline void
 position::piece_map_copy_and_flip(const position& parent)
 {
@@ -562,34 +471,45 @@ position::piece_map_copy_and_flip(const position& parent)
      regenerating it from the piece board appeared to be significantly slower.
      On x86_64 the posrtable code is meant to compile
      as triples of movq - bswapq - movq instructions, or pairs of
-     movbeq - movq. No advantage has been observed using 128 bit vectors,
-     so there is no code for that case. The AVX2 256 bit vectorization
-     might to speed things up a bit.
+     movbeq - movq. The vectorized versions are in copy_and_flip.h,
+     see tests/bench_copy_and_flip.cc for comparing them.
      Note: only the bitboards of specific piece types are needed here,
      so the first 2 bitboards containing the maps of all player::to_move pieces,
      and all player::opponent pieces are skipped. With the padding of 2 bitboards
      at the front of the piece_map_raw array, and 32 byte alignment of the array,
      this means the piece maps starting at piece_map_raw[4] are also 32 bytes
-     aligned. This helps in the implementation of the 256 bit version of the
-     vector_piece_map_copy_and_flip rutine.
+     aligned. The vector implementations don't rely on this anymore.
       ( 2015 February )
       }}}*/
 
-#ifdef KATOR_USE_PIECE_MAP_VECTOR
-  vector_piece_map_copy_and_flip(raw64 + offset_piece_maps,
+#ifdef KATOR_USE_RUNTIME_DISPATCH
+
+  flip_kernel.piece_maps(raw64 + offset_piece_maps,
+                         parent.raw64 + offset_piece_maps);
+
+#elif defined(KATOR_USE_PIECE_MAP_VECTOR)
+
+#  ifdef KATOR_HAS_X64_512BIT_AVX512BW_BUILTINS
+  avx512_piece_map_copy_and_flip(raw64 + offset_piece_maps,
                                  parent.raw64 + offset_piece_maps);
-#else
+#  elif defined(KATOR_HAS_X64_256BIT_AVX2_BUILTINS)
+  avx2_piece_map_copy_and_flip(raw64 + offset_piece_maps,
+                               parent.raw64 + offset_piece_maps);
+#  elif defined(KATOR_HAS_X64_128BIT_SSSE3_SHUFFLE_BUILTIN)
+  ssse3_piece_map_copy_and_flip(raw64 + offset_piece_maps,
+                                parent.raw64 + offset_piece_maps);
+#  elif defined(KATOR_HAS_X64_128BIT_BUILTINS)
+  sse2_piece_map_copy_and_flip(raw64 + offset_piece_maps,
+                               parent.raw64 + offset_piece_maps);
+#  else
+#    error No compiler vector support found for use with piece_maps
+#  endif
 
+#else
 
-  for (auto type : all_piece_types()) {
-    kator::square square = make_square(type, to_move);
-    kator::square opponent_square = make_square(type, opponent);
+  portable_piece_map_copy_and_flip(raw64 + offset_piece_maps,
+                                   parent.raw64 + offset_piece_maps);
 
-    piece_map()[square] =
-      kator::flip(parent.map_of(opponent_square));
-    piece_map()[opponent_square] =
-      kator::flip(parent.map_of(square));
-  }
 #endif
 }
 
@@ -612,21 +532,28 @@ inline void position::move_primary_piece(move move)
      and the square at move.from is cleared.
   }}}*/
 
-  if (move.is_capture()) {
+  if (move.is_capture() and not move.is_en_passant()) {
     piece_map_remove(move.to, make_square(move.captured()));
     zhash_pair()->xor_piece(make_square(move.captured()), move.to);
+    incremental_remove(make_square(move.captured()), move.to);
+    *phase() -= phase_weight(move.captured());
+  }
+  if (move.is_promotion()) {
+    *phase() += phase_weight(move.result());
   }
 
   auto result_piece = make_square(move.result(), opponent);
 
   piece_map_add(result_piece, move.to);
   zhash_pair()->xor_piece(result_piece, move.to);
+  incremental_add(result_piece, move.to);
   set_board_at(move.to, move.result());
 
   auto original_piece = make_square(piece_at(move.from), opponent);
 
   piece_map_remove(move.from, original_piece);
   zhash_pair()->xor_piece(original_piece, move.from);
+  incremental_remove(original_piece, move.from);
   clear_board_at(move.from);
 }
 
@@ -660,6 +587,7 @@ void position::handle_special_move(const position& parent, move move)
         clear_board_at(ep);
         piece_map_remove(ep, pawn);
         zhash_pair()->xor_piece(pawn, ep);
+        incremental_remove(pawn, ep);
       }
       break;
 
@@ -667,16 +595,20 @@ void position::handle_special_move(const position& parent, move move)
       set_board_at(f8, piece::rook);
       clear_board_at(h8);
       piece_map()[opponent_rook] ^= bitboard(f8, h8);
-      zhash_pair()->xor_piece(rook, f8);
-      zhash_pair()->xor_piece(rook, h8);
+      zhash_pair()->xor_piece(opponent_rook, f8);
+      zhash_pair()->xor_piece(opponent_rook, h8);
+      incremental_add(opponent_rook, f8);
+      incremental_remove(opponent_rook, h8);
       break;
 
     case move::castle_queenside:
       set_board_at(d8, piece::rook);
       clear_board_at(a8);
       piece_map()[opponent_rook] ^= bitboard(d8, a8);
-      zhash_pair()->xor_piece(rook, d8);
-      zhash_pair()->xor_piece(rook, a8);
+      zhash_pair()->xor_piece(opponent_rook, d8);
+      zhash_pair()->xor_piece(opponent_rook, a8);
+      incremental_add(opponent_rook, d8);
+      incremental_remove(opponent_rook, a8);
       break;
 
     case move::pawn_double_push:
@@ -687,10 +619,27 @@ void position::handle_special_move(const position& parent, move move)
 }
 
 position::position(const position& parent, move move) noexcept
+{
+  make_child(parent, move);
+}
+
+/* Constructors can not be multiversioned, thus the body of the {{{
+   child position constructor is in a separate member function.
+}}}*/
+KATOR_MULTIVERSION
+void position::make_child(const position& parent, move move) noexcept
 {
   board_copy_and_flip(board.data(), parent.board.data());
   piece_map_copy_and_flip(parent);
   new(castle()) castle_rights(parent.castle()->flipped());
+  *zhash_pair() = parent.zhash_pair()->flipped();
+  *psq() = -parent.piece_square_score();
+  *phase() = parent.game_phase();
+  *pawn_zhash() = parent.get_pawn_zhash().flipped();
+  *material() = parent.get_material_key().flipped();
+  if (parent.has_en_passant_square()) {
+    zhash_pair()->xor_en_passant_file(parent.ep_index().file());
+  }
 
   /* Start with flipping the move, because the coordinates in the move{{{
      refer the squares on the original board. At this point the new board
@@ -709,6 +658,7 @@ position::position(const position& parent, move move) noexcept
 
   if (move.is_double_pawn_push() and has_potential_ep_captor(this, move.to)) {
     en_passant_index()[0] = move.to;
+    zhash_pair()->xor_en_passant_file(move.to.file());
   }
   else {
     en_passant_index()->unset();
@@ -716,6 +666,173 @@ position::position(const position& parent, move move) noexcept
 
 }
 
+bool position::is_pseudo_legal_pawn_move(sq_index from, sq_index to) const
+{
+  if (map_of(opponent).is_bit_set(to)) {
+    return bitboard::pawn_attacks(bitboard(from)).is_bit_set(to);
+  }
+  if (to == north_of(from)) {
+    return true;
+  }
+  return from.rank() == rank_2
+         and to == north_of(north_of(from))
+         and is_unoccupied(north_of(from));
+}
+
+bool position::is_pseudo_legal_castle(sq_index to) const
+{
+  if (in_check()) {
+    return false;
+  }
+  if (to == g1) {
+    return can_castle_kingside()
+           and is_any_unoccupied(f1, g1)
+           and not is_any_attacked_by(opponent, f1, g1);
+  }
+  if (to == c1) {
+    return can_castle_queenside()
+           and is_any_unoccupied(b1, c1, d1)
+           and not is_any_attacked_by(opponent, c1, d1);
+  }
+  return false;
+}
+
+bool position::is_pseudo_legal(packed_move pm) const
+{
+  sq_index from = pm.from();
+  sq_index to = pm.to();
+
+  if (pm.is_null()
+      or not map_of(to_move).is_bit_set(from)
+      or map_of(to_move).is_bit_set(to))
+  {
+    return false;
+  }
+
+  piece moving = piece_at(from);
+
+  switch (pm.flags()) {
+    case packed_move::castle:
+      return moving == piece::king and from == e1
+             and is_pseudo_legal_castle(to);
+
+    case packed_move::en_passant:
+      return moving == piece::pawn
+             and has_en_passant_square()
+             and to == north_of(ep_index())
+             and bitboard::pawn_attacks(bitboard(from)).is_bit_set(to);
+
+    case packed_move::promotion:
+      return moving == piece::pawn
+             and to.rank() == rank_8
+             and is_pseudo_legal_pawn_move(from, to);
+
+    case packed_move::normal:
+      break;
+  }
+
+  switch (moving) {
+    case piece::pawn:
+      return to.rank() != rank_8 and is_pseudo_legal_pawn_move(from, to);
+    case piece::knight:
+      return bitboard::knight_attacks(from).is_bit_set(to);
+    case piece::king:
+      return bitboard::king_attacks(from).is_bit_set(to);
+    case piece::bishop:
+      return bitboard::bishop_attacks(occupied(), from).is_bit_set(to);
+    case piece::rook:
+      return bitboard::rook_attacks(occupied(), from).is_bit_set(to);
+    case piece::queen:
+      return bitboard::bishop_attacks(occupied(), from).is_bit_set(to)
+             or bitboard::rook_attacks(occupied(), from).is_bit_set(to);
+  }
+  return false;
+}
+
+move position::unpack(packed_move pm) const
+{
+  sq_index from = pm.from();
+  sq_index to = pm.to();
+
+  switch (pm.flags()) {
+    case packed_move::castle:
+      return (to == g1) ? castle_kingside : castle_queenside;
+
+    case packed_move::en_passant:
+      return move(from, to, piece::pawn, piece::pawn, move::en_passant);
+
+    case packed_move::promotion:
+      return move(from, to, pm.promotion_piece(), piece_at(to),
+                  move::promotion);
+
+    case packed_move::normal:
+      break;
+  }
+
+  piece moving = piece_at(from);
+
+  if (moving == piece::pawn and from.rank() == rank_2 and to.rank() == rank_4) {
+    return move(from, to, piece::pawn, move::pawn_double_push);
+  }
+  return move(from, to, moving, piece_at(to), move::general);
+}
+
+zobrist_hash position::key_after(move move) const
+{
+  /* The same changes as in the constructor above, but applied {{{
+     from the point of view of the player making the move, i.e.
+     the move is not flipped. Flipping the resulting pair at the end
+     yields the hash as seen by the next player.
+  }}}*/
+  zobrist_hash_pair zhash = *zhash_pair();
+
+  if (move.is_capture()) {
+    sq_index victim = move.is_en_passant() ? ep_index() : move.to;
+
+    zhash.xor_piece(make_square(move.captured(), opponent), victim);
+  }
+  zhash.xor_piece(make_square(move.result()), move.to);
+  zhash.xor_piece(square_at(move.from), move.from);
+
+  if (move.is_castle_kingside()) {
+    zhash.xor_piece(rook, h1);
+    zhash.xor_piece(rook, f1);
+  }
+  else if (move.is_castle_queenside()) {
+    zhash.xor_piece(rook, a1);
+    zhash.xor_piece(rook, d1);
+  }
+
+  if (can_castle_queenside() and (move.from == e1 or move.from == a1)) {
+    zhash.xor_castle_right(castle_rights::side::queenside);
+  }
+  if (can_castle_kingside() and (move.from == e1 or move.from == h1)) {
+    zhash.xor_castle_right(castle_rights::side::kingside);
+  }
+  if (opponent_can_castle_queenside() and move.to == a8) {
+    zhash.xor_castle_right(castle_rights::side::opponent_queenside);
+  }
+  if (opponent_can_castle_kingside() and move.to == h8) {
+    zhash.xor_castle_right(castle_rights::side::opponent_kingside);
+  }
+
+  if (has_en_passant_square()) {
+    zhash.xor_en_passant_file(ep_index().file());
+  }
+  if (move.is_double_pawn_push()) {
+    bitboard captors = intersection_of(
+        union_of(bitboard::left_of(bitboard(move.to) & compl bitboard(file_a)),
+                 bitboard::right_of(bitboard(move.to) & compl bitboard(file_h))),
+        map_of(opponent_pawn));
+
+    if (captors.is_nonempty()) {
+      zhash.xor_en_passant_file(move.to.file());
+    }
+  }
+
+  return zhash.flipped();
+}
+
 string position::generate_castle_FEN(real_player point_of_view) const
 {
   return castle()->generate_castle_FEN(point_of_view);
@@ -7,6 +7,8 @@
 #include "platform/platform.h"
 #include "bitboard.h"
 #include "zobrist_hash.h"
+#include "piece_square.h"
+#include "material_key.h"
 
 #include <algorithm>
 #include <array>
@@ -24,8 +26,9 @@ public: /* The public interface */
   static constexpr position_player to_move = player_to_move;
   static constexpr position_player opponent = player_opponent;
 
+  /* Heap positions come from the block pool, see block_pool.h */
   static void* operator new(size_t);
-  static void operator delete(void*);
+  static void operator delete(void*, size_t);
 
   position(const position&, move) noexcept /* GCC __attribute__((hot)) */;
   position(const position&) = default;
@@ -80,6 +83,32 @@ public: /* The public interface */
 
   zobrist_hash get_zhash() const;
 
+  pawn_hash get_pawn_zhash() const;
+  material_key get_material_key() const;
+
+  /* The sum of the piece_square_table entries of all pieces */
+  psq_score piece_square_score() const;
+
+  /* See max_game_phase in piece_square.h */
+  unsigned game_phase() const;
+
+  /* The hash of the position resulting from making the move, {{{
+     computed without constructing that position. This allows
+     prefetching the hash table entry of a child, before doing
+     the more expensive work of the child's constructor.
+  }}}*/
+  zobrist_hash key_after(move) const;
+
+  /* Validating a move from the hash table, or a killer move, {{{
+     without generating any moves. A pseudo legal move is one the
+     piece on the from square is able to make, but it might still
+     leave the king in check. The unpack method expects a pseudo
+     legal move, and restores all the information not stored in
+     a packed_move.
+  }}}*/
+  bool is_pseudo_legal(packed_move) const;
+  move unpack(packed_move) const;
+
 private:
 
 
@@ -109,6 +138,11 @@ private:
        of said bishop and the squares enclosed between the bishop and
        the king in the related diagonal. Of course, when the king is not
        in check, this bitboard is empty.
+     The 64 bit slot at offset_psq_score holds the running sum of
+     piece-square values in its first half, and the game phase in the
+     second one, see piece_square.h
+     The slot at offset_pawn_zhash holds the hash of the pawns only,
+     and the last slot holds the material_key.
    }}}*/
 
   alignas(critical_alignment) std::array<unsigned char, 64> board;
@@ -125,10 +159,11 @@ private:
     offset_piece_maps,
     offset_zhash_pair = offset_piece_maps + piece_array_size - 2,
     offset_zhash_pair_second,
-    raw64_padding_0,
-    raw64_padding_1,
+    offset_psq_score,
+    offset_pawn_zhash,
     offset_attack_maps,
-    uint64_array_size = offset_attack_maps + piece_array_size - 2
+    offset_material_key = offset_attack_maps + piece_array_size - 2,
+    uint64_array_size
   };
 
   alignas(critical_alignment) uint64_t raw64[uint64_array_size];
@@ -258,6 +293,63 @@ private:
     return reinterpret_cast<const zobrist_hash_pair*>(pointer);
   }
 
+  psq_score* psq()
+  {
+    return reinterpret_cast<psq_score*>(raw64 + offset_psq_score);
+  }
+
+  const psq_score* psq() const
+  {
+    return reinterpret_cast<const psq_score*>(raw64 + offset_psq_score);
+  }
+
+  uint32_t* phase()
+  {
+    return reinterpret_cast<uint32_t*>(raw64 + offset_psq_score) + 1;
+  }
+
+  const uint32_t* phase() const
+  {
+    return reinterpret_cast<const uint32_t*>(raw64 + offset_psq_score) + 1;
+  }
+
+  pawn_hash* pawn_zhash()
+  {
+    return reinterpret_cast<pawn_hash*>(raw64 + offset_pawn_zhash);
+  }
+
+  const pawn_hash* pawn_zhash() const
+  {
+    return reinterpret_cast<const pawn_hash*>(raw64 + offset_pawn_zhash);
+  }
+
+  material_key* material()
+  {
+    return reinterpret_cast<material_key*>(raw64 + offset_material_key);
+  }
+
+  const material_key* material() const
+  {
+    return reinterpret_cast<const material_key*>(raw64 + offset_material_key);
+  }
+
+  /* Updating the incremental evaluation terms, when a piece is {{{
+     placed on, or removed from a square.
+  }}}*/
+  void incremental_add(square piece, sq_index index)
+  {
+    *psq() += piece_square_table[piece][index.offset()];
+    pawn_zhash()->xor_piece(piece, index);
+    material()->add(piece);
+  }
+
+  void incremental_remove(square piece, sq_index index)
+  {
+    *psq() -= piece_square_table[piece][index.offset()];
+    pawn_zhash()->xor_piece(piece, index);
+    material()->remove(piece);
+  }
+
   void clear_board_and_piece_maps();
   void piece_map_copy_and_flip(const position& parent);
 
@@ -276,6 +368,9 @@ private:
 
   void move_primary_piece(move);
   void handle_special_move(const position&, move);
+  void make_child(const position& parent, move) noexcept;
+  bool is_pseudo_legal_pawn_move(sq_index from, sq_index to) const;
+  bool is_pseudo_legal_castle(sq_index to) const;
   void handle_castle_rights(move);
 
   void generate_attacks_by_piece();
@@ -289,6 +384,7 @@ private:
            const real_player player_to_move);
 
   friend struct game_state;
+  friend engine::node;
 
 }; /* class position */
 
@@ -541,6 +637,26 @@ inline zobrist_hash position::get_zhash() const
   return *zhash_pair();
 }
 
+inline pawn_hash position::get_pawn_zhash() const
+{
+  return *pawn_zhash();
+}
+
+inline material_key position::get_material_key() const
+{
+  return *material();
+}
+
+inline psq_score position::piece_square_score() const
+{
+  return *psq();
+}
+
+inline unsigned position::game_phase() const
+{
+  return *phase();
+}
+
 
 } /* namespace kator */
 
@@ -240,6 +240,7 @@ public:
   friend range::iterator;
   friend class bitboard;
   friend struct move;
+  friend class packed_move;
 
 }; /* class sq_index */
 
@@ -32,8 +32,37 @@ private:
   uint64_t value;
   static const uint64_t z_random[piece_array_size + 1][64];
 
+  friend class pawn_hash;
+
 }; /* class zobrist_hash */
 
+/* A hash of the pawns only, the key of the pawn hash table. {{{
+   Unlike the zobrist_hash_pair, it fits in one 64 bit word: the value
+   of an opponent's pawn is the value of a pawn on the flipped square,
+   rotated by 32 bits. Flipping the board is thus rotating the key by
+   32 bits -- the same structure seen by the other player hashes to
+   a different key. Calling xor_piece with any other piece is a no-op.
+}}}*/
+class pawn_hash
+{
+public:
+
+  constexpr pawn_hash(): value(0) {}
+  void xor_piece(square, sq_index);
+  pawn_hash flipped() const;
+  constexpr uint64_t get_value() const;
+
+private:
+
+  uint64_t value;
+
+  static constexpr uint64_t rotated(uint64_t raw)
+  {
+    return (raw << 32) | (raw >> 32);
+  }
+
+}; /* class pawn_hash */
+
 class zobrist_hash_pair
 {
 public:
@@ -95,6 +124,12 @@ inline void zobrist_hash_pair::xor_castle_right(castle_rights::side side)
   opponent_hash.xor_castle_right(opponent_of(side));
 }
 
+inline void zobrist_hash_pair::xor_en_passant_file(file file)
+{
+  hash.xor_en_passant_file(file);
+  opponent_hash.xor_en_passant_file(file);
+}
+
 inline zobrist_hash_pair::operator zobrist_hash() const
 {
   return hash;
@@ -106,6 +141,29 @@ inline zobrist_hash_pair::zobrist_hash_pair():
 {
 }
 
+inline void pawn_hash::xor_piece(square piece, sq_index index)
+{
+  if (piece == pawn) {
+    value ^= zobrist_hash::z_random[pawn][index.offset()];
+  }
+  else if (piece == opponent_pawn) {
+    value ^= rotated(zobrist_hash::z_random[pawn][flip(index).offset()]);
+  }
+}
+
+inline pawn_hash pawn_hash::flipped() const
+{
+  pawn_hash result;
+
+  result.value = rotated(value);
+  return result;
+}
+
+inline constexpr uint64_t pawn_hash::get_value() const
+{
+  return value;
+}
+
 inline zobrist_hash_pair zobrist_hash_pair::initial()
 {
   return zobrist_hash_pair();
@@ -0,0 +1,142 @@
+
+#include "activity.h"
+
+#include "platform/vectors.h"
+
+namespace kator
+{
+namespace engine
+{
+
+constexpr std::array<piece, 4> activity_counts::pieces;
+constexpr unsigned activity_counts::batch_size;
+
+namespace
+{
+
+u64x4 attack_maps_of(const ::kator::position& position,
+                     position_player player)
+{
+  const auto& pieces = activity_counts::pieces;
+
+  return make_u64x4(
+    position.attacks_of(make_square(pieces[0], player)).to_uint64_t(),
+    position.attacks_of(make_square(pieces[1], player)).to_uint64_t(),
+    position.attacks_of(make_square(pieces[2], player)).to_uint64_t(),
+    position.attacks_of(make_square(pieces[3], player)).to_uint64_t());
+}
+
+void store_lanes(u64x4 counts, std::array<uint8_t, 4>& destination)
+{
+  for (unsigned i = 0; i < destination.size(); ++i) {
+    destination[i] = static_cast<uint8_t>(lane_of(counts, i));
+  }
+}
+
+bitboard king_zone(sq_index king)
+{
+  return bitboard::king_attacks(king) | bitboard(king);
+}
+
+typedef const ::kator::position* const* position_batch;
+
+static_assert(activity_counts::batch_size == 4,
+              "a batch of positions fills the four lanes of a u64x4");
+
+// A map of each position of a batch, in the lanes of a vector
+template<typename function>
+u64x4 gather(position_batch positions, function map_of)
+{
+  return make_u64x4(map_of(*positions[0]).to_uint64_t(),
+                    map_of(*positions[1]).to_uint64_t(),
+                    map_of(*positions[2]).to_uint64_t(),
+                    map_of(*positions[3]).to_uint64_t());
+}
+
+void store_lanes(u64x4 counts, activity_counts* destination,
+                 std::array<uint8_t, 4> activity_counts::* member,
+                 unsigned index)
+{
+  for (unsigned i = 0; i < activity_counts::batch_size; ++i) {
+    (destination[i].*member)[index] = static_cast<uint8_t>(lane_of(counts, i));
+  }
+}
+
+} /* anonym namespace */
+
+/* All sixteen counts in four vector popcounts, the attack maps {{{
+   of the four piece types in the lanes of a vector.
+}}}*/
+activity_counts count_activity(const ::kator::position& position)
+{
+  u64x4 attacks = attack_maps_of(position, player_to_move);
+  u64x4 opponent_attacks = attack_maps_of(position, player_opponent);
+
+  bitboard area = compl (position.map_of(player_to_move)
+                         | position.attacks_of(opponent_pawn));
+  bitboard opponent_area = compl (position.map_of(player_opponent)
+                                  | position.attacks_of(pawn));
+
+  u64x4 mobility = attacks & broadcast_u64x4(area.to_uint64_t());
+  u64x4 opponent_mobility =
+    opponent_attacks & broadcast_u64x4(opponent_area.to_uint64_t());
+  u64x4 zone_attacks = attacks & broadcast_u64x4(
+      king_zone(position.opponent_king_index()).to_uint64_t());
+  u64x4 opponent_zone_attacks = opponent_attacks & broadcast_u64x4(
+      king_zone(position.king_index()).to_uint64_t());
+
+  activity_counts counts;
+
+  store_lanes(popcnt_lanes(mobility), counts.mobility);
+  store_lanes(popcnt_lanes(opponent_mobility), counts.opponent_mobility);
+  store_lanes(popcnt_lanes(zone_attacks), counts.king_zone_attacks);
+  store_lanes(popcnt_lanes(opponent_zone_attacks),
+              counts.opponent_king_zone_attacks);
+  return counts;
+}
+
+/* The same counts as above, but each vector holding one kind of {{{
+   attack map of four positions -- sixteen popcounts of four lanes.
+}}}*/
+void count_activity(position_batch positions, activity_counts* counts)
+{
+  typedef const ::kator::position& position_ref;
+
+  u64x4 area = compl gather(positions, [](position_ref position) {
+    return position.map_of(player_to_move)
+           | position.attacks_of(opponent_pawn);
+  });
+  u64x4 opponent_area = compl gather(positions, [](position_ref position) {
+    return position.map_of(player_opponent) | position.attacks_of(pawn);
+  });
+  u64x4 zone = gather(positions, [](position_ref position) {
+    return king_zone(position.opponent_king_index());
+  });
+  u64x4 opponent_zone = gather(positions, [](position_ref position) {
+    return king_zone(position.king_index());
+  });
+
+  for (unsigned i = 0; i < activity_counts::pieces.size(); ++i) {
+    square piece = make_square(activity_counts::pieces[i], player_to_move);
+    square opponent_piece = opponent_of(piece);
+
+    u64x4 attacks = gather(positions, [=](position_ref position) {
+      return position.attacks_of(piece);
+    });
+    u64x4 opponent_attacks = gather(positions, [=](position_ref position) {
+      return position.attacks_of(opponent_piece);
+    });
+
+    store_lanes(popcnt_lanes(attacks & area), counts,
+                &activity_counts::mobility, i);
+    store_lanes(popcnt_lanes(opponent_attacks & opponent_area), counts,
+                &activity_counts::opponent_mobility, i);
+    store_lanes(popcnt_lanes(attacks & zone), counts,
+                &activity_counts::king_zone_attacks, i);
+    store_lanes(popcnt_lanes(opponent_attacks & opponent_zone), counts,
+                &activity_counts::opponent_king_zone_attacks, i);
+  }
+}
+
+} /* namespace kator::engine */
+} /* namespace kator */
@@ -0,0 +1,50 @@
+
+#ifndef KATOR_ENGINE_ACTIVITY_H
+#define KATOR_ENGINE_ACTIVITY_H
+
+#include <array>
+#include <cstdint>
+
+#include "chess/position.h"
+
+namespace kator
+{
+namespace engine
+{
+
+/* Counts derived from the attack maps kept by the position. {{{
+   Each array follows the order of activity_counts::pieces.
+   The attack maps are per piece type -- the union of the attacks of
+   e.g. both knights -- thus a square attacked by both is counted once.
+   Mobility counts the squares not occupied by the player's own
+   pieces, and not attacked by the other player's pawns.
+   The king zone attacks count the squares around the other player's
+   king ( and the king's own square ) attacked.
+}}}*/
+struct activity_counts
+{
+  std::array<uint8_t, 4> mobility;
+  std::array<uint8_t, 4> opponent_mobility;
+  std::array<uint8_t, 4> king_zone_attacks;
+  std::array<uint8_t, 4> opponent_king_zone_attacks;
+
+  static constexpr std::array<piece, 4> pieces = {{
+    piece::rook, piece::bishop, piece::knight, piece::queen
+  }};
+
+  static constexpr unsigned batch_size = 4;
+
+}; /* struct activity_counts */
+
+activity_counts count_activity(const ::kator::position&);
+
+/* The counts of activity_counts::batch_size positions at once, {{{
+   each lane of the vectors belonging to a different position.
+}}}*/
+void count_activity(const ::kator::position* const* positions,
+                    activity_counts* counts);
+
+} /* namespace kator::engine */
+} /* namespace kator */
+
+#endif /* !defined(KATOR_ENGINE_ACTIVITY_H) */
@@ -0,0 +1,99 @@
+
+#include "endgame.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace kator
+{
+namespace engine
+{
+
+namespace
+{
+
+// Surely winning, but less than the value of a queen
+constexpr int known_win = 0x80;
+
+int distance(sq_index a, sq_index b)
+{
+  int rank_delta = std::abs(int(a.rank().offset()) - int(b.rank().offset()));
+  int file_delta = std::abs(int(a.file().offset()) - int(b.file().offset()));
+
+  return std::max(rank_delta, file_delta);
+}
+
+// Zero on the four center squares, three on the edges
+int distance_from_center(sq_index index)
+{
+  int rank = int(index.rank().offset());
+  int file = int(index.file().offset());
+
+  return std::max(std::max(3 - rank, rank - 4), std::max(3 - file, file - 4));
+}
+
+bool is_light_square(sq_index index)
+{
+  return ((index.rank().offset() + index.file().offset()) % 2) != 0;
+}
+
+sq_index king_of(const ::kator::position& position, position_player player)
+{
+  return (player == player_to_move)
+         ? position.king_index()
+         : position.opponent_king_index();
+}
+
+position_value from_view_of(position_player strong_side, int value)
+{
+  if (strong_side == player_to_move) {
+    return position_value::create_from_int(value);
+  }
+  else {
+    return position_value::create_from_int(-value);
+  }
+}
+
+} /* anonym namespace */
+
+position_value evaluate_krk(const ::kator::position& position,
+                            position_player strong_side)
+{
+  sq_index weak_king = king_of(position, opponent_of(strong_side));
+  sq_index strong_king = king_of(position, strong_side);
+
+  int value = known_win
+              + 4 * distance_from_center(weak_king)
+              + 2 * (7 - distance(weak_king, strong_king));
+
+  return from_view_of(strong_side, value);
+}
+
+/* The mate can only be forced in a corner of the bishop's color, {{{
+   the defending king is driven towards the nearest one of those.
+}}}*/
+position_value evaluate_kbnk(const ::kator::position& position,
+                             position_player strong_side)
+{
+  sq_index weak_king = king_of(position, opponent_of(strong_side));
+  sq_index strong_king = king_of(position, strong_side);
+  unsigned bishop_square = make_square(piece::bishop, strong_side);
+  bool light = is_light_square(position.map_of(bishop_square).lsb_index());
+
+  int corner_distance = 7;
+  for (auto corner : {a1, h1, a8, h8}) {
+    if (is_light_square(corner) == light) {
+      corner_distance = std::min(corner_distance,
+                                 distance(weak_king, corner));
+    }
+  }
+
+  int value = known_win
+              + 4 * (7 - corner_distance)
+              + 2 * (7 - distance(weak_king, strong_king));
+
+  return from_view_of(strong_side, value);
+}
+
+} /* namespace kator::engine */
+} /* namespace kator */
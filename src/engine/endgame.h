@@ -0,0 +1,34 @@
+
+#ifndef KATOR_ENGINE_ENDGAME_H
+#define KATOR_ENGINE_ENDGAME_H
+
+#include "eval.h"
+#include "chess/position.h"
+
+namespace kator
+{
+namespace engine
+{
+
+/* Specialized evaluation of some endgames with known outcome. {{{
+   Each of these replaces the general evaluation, when the material
+   on the board matches the endgame. The strong side is the one with
+   the pieces, the other one has a bare king. The value returned is
+   from the point of view of the player to move, as usual.
+   These do not play the endgame perfectly, just guide the search
+   in the right direction: driving the defending king to the
+   edge, or to the right corner, with the attacking king close to it.
+}}}*/
+typedef position_value (*endgame_function)(const ::kator::position&,
+                                           position_player strong_side);
+
+// King and rook versus king
+position_value evaluate_krk(const ::kator::position&, position_player);
+
+// King, bishop and knight versus king
+position_value evaluate_kbnk(const ::kator::position&, position_player);
+
+} /* namespace kator::engine */
+} /* namespace kator */
+
+#endif /* !defined(KATOR_ENGINE_ENDGAME_H) */
@@ -29,9 +29,9 @@ class engine_implementation : public engine
   unsigned max_time;
   bool is_search_running;
   std::vector<unique_ptr<search> > workers;
-  function<void(result)> sub_result_callback;
-  function<void(result)> final_result_callback;
-  function<void(result)> fixed_result_callback;
+  function<void(const result&)> sub_result_callback;
+  function<void(const result&)> final_result_callback;
+  function<void(const result&)> fixed_result_callback;
 
   unique_ptr<game_state> root;
 
@@ -73,17 +73,17 @@ public:
     return is_search_running;
   }
 
-  void set_sub_result_callback(function<void(result)> callback)
+  void set_sub_result_callback(function<void(const result&)> callback)
   {
     sub_result_callback = callback;
   }
 
-  void set_final_result_callback(function<void(result)> callback)
+  void set_final_result_callback(function<void(const result&)> callback)
   {
     final_result_callback = callback;
   }
 
-  void set_fixed_result_callback(function<void(result)> callback)
+  void set_fixed_result_callback(function<void(const result&)> callback)
   {
     fixed_result_callback = callback;
   }
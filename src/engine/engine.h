@@ -8,8 +8,8 @@
 
 #include "chess/chess.h"
 #include "chess/move.h"
-#include "chess/move_list.h"
 #include "eval.h"
+#include "principal_variation.h"
 #include "search.h"
 
 namespace kator
@@ -22,7 +22,7 @@ class search;
 struct result
 {
   unsigned depth;
-  move_list pv;
+  principal_variation pv;
   move best_move;
   position_value value;
 };
@@ -40,9 +40,12 @@ public:
   virtual void set_max_time(unsigned ms) = 0;
   //virtual void set_thread_count(unsigned) = 0;
   //virtual void get_thread_count(unsigned) const noexcept = 0;
-  virtual void set_sub_result_callback(std::function<void(result)>) = 0;
-  virtual void set_final_result_callback(std::function<void(result)>) = 0;
-  virtual void set_fixed_result_callback(std::function<void(result)>) = 0;
+  virtual void set_sub_result_callback(
+      std::function<void(const result&)>) = 0;
+  virtual void set_final_result_callback(
+      std::function<void(const result&)>) = 0;
+  virtual void set_fixed_result_callback(
+      std::function<void(const result&)>) = 0;
   virtual void start(std::unique_ptr<game_state> root) = 0;
   virtual ~engine() {}
 };
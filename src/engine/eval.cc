@@ -1,8 +1,13 @@
 
-#include <sstream>
+#include <algorithm>
+#include <cstring>
 #include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
 #include <regex>
 #include <map>
+#include <utility>
 #include <string>
 #include <cstdlib>
 #include <climits>
@@ -18,89 +23,175 @@ namespace kator
 namespace engine
 {
 
-std::array<short, piece_array_size> position_value::piece_values;
-move::change_array_t<short> position_value::move_change_table;
-
 namespace
 {
 
 typedef std::map<string, short> conf_t;
 
+struct evaluation_parameters
+{
+  short pawn;
+  short rook;
+  short knight;
+  short bishop;
+  short queen;
+  short king_pawn_fence;
+  short empty_between_king_and_corner;
+  short lazy_margin_midgame;
+  short lazy_margin_endgame;
+};
+
 #include "default_values.inc"
 
-void setup_piece_values(std::array<short, piece_array_size>& values,
-                        const conf_t& conf)
-{
-  values[pawn] =   conf.at("pawn");
-  values[rook] =   conf.at("rook");
-  values[knight] = conf.at("knight");
-  values[bishop] = conf.at("bishop");
-  values[queen] =  conf.at("queen");
-  values[opponent_pawn] =   -conf.at("pawn");
-  values[opponent_rook] =   -conf.at("rook");
-  values[opponent_knight] = -conf.at("knight");
-  values[opponent_bishop] = -conf.at("bishop");
-  values[opponent_queen] =  -conf.at("queen");
-}
-
-template<typename... extra_argument>
-void add_promotion_values(move::change_array_t<short>& move_change_table,
-                          extra_argument... extra)
-{
-  auto entry = [&](piece type) -> short&
-  {
-    auto index = move::change_index(type, extra..., move::promotion);
-    return move_change_table[index];
-  };
-
-  entry(piece::queen) =
-                    (position_value(queen) - position_value(pawn)).as_short();
-  entry(piece::rook) =
-                    (position_value(rook) - position_value(pawn)).as_short();
-  entry(piece::knight) =
-                    (position_value(knight) - position_value(pawn)).as_short();
-  entry(piece::bishop) =
-                    (position_value(bishop) - position_value(pawn)).as_short();
-}
-
-void setup_move_changes(move::change_array_t<short>& move_change_table)
-{
-  auto set = [&](position_value value, piece result, piece captured,
-                 move::move_type_enum type)
-  {
-    short short_value = value.as_short();
-
-    move_change_table[move::change_index(result, captured, type)] = short_value;
-  };
-
-  for (auto captured : all_piece_types()) {
-    for (auto result : all_piece_types()) {
-      set(position_value(captured), result, captured, move::general);
-    }
-    add_promotion_values(move_change_table, captured);
+const std::array<std::pair<const char*, short evaluation_parameters::*>, 9>
+parameter_names = {{
+  { "pawn", &evaluation_parameters::pawn },
+  { "rook", &evaluation_parameters::rook },
+  { "knight", &evaluation_parameters::knight },
+  { "bishop", &evaluation_parameters::bishop },
+  { "queen", &evaluation_parameters::queen },
+  { "king_pawn_fence", &evaluation_parameters::king_pawn_fence },
+  { "empty_between_king_and_corner",
+    &evaluation_parameters::empty_between_king_and_corner },
+  { "lazy_margin_midgame", &evaluation_parameters::lazy_margin_midgame },
+  { "lazy_margin_endgame", &evaluation_parameters::lazy_margin_endgame }
+}};
+
+typedef std::array<short, piece_array_size> piece_value_array;
+typedef move::change_array_t<short> move_change_array;
+
+constexpr piece_value_array
+piece_values_of(const evaluation_parameters& parameters)
+{
+  return {{
+    0, 0,
+    parameters.pawn, short(-parameters.pawn),
+    parameters.rook, short(-parameters.rook),
+    0, 0, // kings
+    parameters.bishop, short(-parameters.bishop),
+    parameters.knight, short(-parameters.knight),
+    parameters.queen, short(-parameters.queen)
+  }};
+}
+
+constexpr bool is_piece_type(unsigned value)
+{
+  return value >= pawn and value <= queen and value % 2 == 0;
+}
+
+constexpr bool is_promotion_piece(unsigned value)
+{
+  return value == queen or value == rook
+         or value == knight or value == bishop;
+}
+
+/* The entry at a move::change_index: the value of the captured {{{
+   piece, or the value gained by a promotion.
+}}}*/
+constexpr short move_change(const piece_value_array& values, unsigned index)
+{
+  unsigned type = index & 7;
+  unsigned result = (index >> 3) & 0x1f;
+  unsigned captured = index >> 8;
+
+  if (type == move::general
+      and is_piece_type(result) and is_piece_type(captured)) {
+    return values[captured];
+  }
+  if (type == move::promotion
+      and is_promotion_piece(result)
+      and (captured == 0 or is_piece_type(captured))) {
+    return short(values[result] - values[pawn] + values[captured]);
   }
-  add_promotion_values(move_change_table);
-  set(position_value(pawn), piece::pawn, piece::pawn, move::en_passant);
+  if (type == move::en_passant and result == pawn and captured == pawn) {
+    return values[pawn];
+  }
+  return 0;
 }
 
-} // anonym namespace
+template<size_t... indices>
+constexpr move_change_array
+move_changes_of(const piece_value_array& values,
+                std::index_sequence<indices...>)
+{
+  return {{ move_change(values, indices)... }};
+}
+
+constexpr move_change_array
+move_changes_of(const piece_value_array& values)
+{
+  return move_changes_of(values, std::make_index_sequence<
+      std::tuple_size<move_change_array>::value>());
+}
+
+constexpr piece_value_array default_piece_values =
+  piece_values_of(default_evaluation_parameters);
 
-void position_value::default_initialize_lookup_tables()
+constexpr const psq_parameters& default_psq_midgame(unsigned piece)
 {
-  std::stringstream stream(default_evaluation_values);
+  return (piece == pawn) ? default_pawn_midgame
+       : (piece == rook) ? default_rook_midgame
+       : (piece == king) ? default_king_midgame
+       : (piece == bishop) ? default_bishop
+       : (piece == knight) ? default_knight
+       : default_queen;
+}
 
-  initialize_lookup_tables(stream);
+constexpr const psq_parameters& default_psq_endgame(unsigned piece)
+{
+  return (piece == pawn) ? default_pawn_endgame
+       : (piece == rook) ? default_rook_endgame
+       : (piece == king) ? default_king_endgame
+       : (piece == bishop) ? default_bishop
+       : (piece == knight) ? default_knight
+       : default_queen;
 }
 
-void position_value::initialize_lookup_tables(const string& path)
+/* The entry of a square at an sq_index offset. The parameters are {{{
+   listed from a8 to h1, which is the offset with the file reversed.
+   The opponent's pieces are seen from the other side of the board.
+}}}*/
+constexpr psq_score psq_entry(unsigned square, unsigned offset)
 {
-  std::ifstream file;
+  unsigned piece = square & ~1u;
+  bool is_opponent = (square & 1) != 0;
+  unsigned index = (is_opponent ? (offset ^ 0x38) : offset) ^ 7;
 
-  file.open(path);
-  initialize_lookup_tables(file);
-  file.close();
+  if (not is_piece_type(piece)) {
+    return psq_score();
+  }
+
+  psq_score entry(default_psq_midgame(piece)[index],
+                  default_psq_endgame(piece)[index]);
+
+  return is_opponent ? -entry : entry;
+}
+
+template<size_t square, size_t... offsets>
+constexpr std::array<psq_score, 64>
+psq_row_of(std::index_sequence<offsets...>)
+{
+  return {{ psq_entry(square, offsets)... }};
 }
 
+template<size_t... squares>
+constexpr psq_table psq_table_of(std::index_sequence<squares...>)
+{
+  return {{ psq_row_of<squares>(std::make_index_sequence<64>())... }};
+}
+
+} // anonym namespace
+
+/* Constant initialized, no setup is needed before using these */
+std::array<short, piece_array_size> position_value::piece_values =
+  default_piece_values;
+move::change_array_t<short> position_value::move_change_table =
+  move_changes_of(default_piece_values);
+psq_score position_value::lazy_margin(
+  default_evaluation_parameters.lazy_margin_midgame,
+  default_evaluation_parameters.lazy_margin_endgame);
+unsigned position_value::parameter_generation = 0;
+
 namespace
 {
 
@@ -117,11 +208,11 @@ short parse_number(const string& value, int base)
   long result;
 
   if (value.size() > 5) {
-    throw;
+    throw std::invalid_argument("evaluation parameter out of range: " + value);
   }
   result = strtol(value.c_str(), &pend, base);
   if (result < SHRT_MIN or result > SHRT_MAX or *pend != '\0') {
-    throw;
+    throw std::invalid_argument("evaluation parameter out of range: " + value);
   }
   return short(result);
 }
@@ -143,7 +234,7 @@ void get_key_value_strings(const string& line, string& key, short& value)
       value = parse_number(key_value[2], 16);
     }
     else {
-      throw;
+      throw std::invalid_argument("invalid evaluation parameter: " + line);
     }
   }
   key = key_value[1];
@@ -168,22 +259,144 @@ static void read_conf(std::istream& stream, conf_t& conf)
   }
 }
 
-void position_value::initialize_lookup_tables(std::istream& stream)
+namespace
+{
+
+evaluation_parameters parse_parameters(std::istream& stream)
 {
   conf_t conf;
+  evaluation_parameters parameters = default_evaluation_parameters;
 
   read_conf(stream, conf);
-  setup_piece_values(piece_values, conf);
-  setup_move_changes(move_change_table);
+  for (const auto& name : parameter_names) {
+    auto value = conf.find(name.first);
+
+    if (value != conf.end()) {
+      parameters.*name.second = value->second;
+    }
+  }
+  return parameters;
+}
+
+/* The binary format: the eight bytes "KATOREP1", the count of {{{
+   parameters as an uint32, and the parameters as int16 values, in
+   the order of parameter_names -- all in the byte order of the host.
+   No parsing, just copying the values into place.
+}}}*/
+constexpr char binary_magic[8] = { 'K', 'A', 'T', 'O', 'R', 'E', 'P', '1' };
+constexpr size_t binary_size = sizeof(binary_magic) + sizeof(uint32_t)
+                               + parameter_names.size() * sizeof(short);
+
+bool is_binary(const void* data, size_t size)
+{
+  return size >= sizeof(binary_magic)
+         and std::memcmp(data, binary_magic, sizeof(binary_magic)) == 0;
 }
 
-position_value::position_value(const position& position):
-  internal(0)
+psq_score lazy_margin_of(const evaluation_parameters& parameters)
 {
-  for (auto index : sq_index::range()) {
-    operator+(position.piece_at(index));
+  return psq_score(parameters.lazy_margin_midgame,
+                   parameters.lazy_margin_endgame);
+}
+
+} // anonym namespace
+
+/* The move change table is derived from the piece values only, {{{
+   and is rebuilt only if those change -- most parameter sets swapped
+   during tuning differ in other values.
+}}}*/
+void position_value::set_parameters(const piece_value_array& values,
+                                    psq_score margin)
+{
+  if (values != piece_values) {
+    piece_values = values;
+    move_change_table = move_changes_of(piece_values);
+  }
+  lazy_margin = margin;
+  ++parameter_generation;
+}
+
+void position_value::initialize_lookup_tables(std::istream& stream)
+{
+  evaluation_parameters parameters = parse_parameters(stream);
+
+  set_parameters(piece_values_of(parameters), lazy_margin_of(parameters));
+}
+
+void position_value::initialize_lookup_tables(const void* data, size_t size)
+{
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  uint32_t count;
+
+  if (not is_binary(data, size) or size != binary_size) {
+    throw std::invalid_argument("invalid evaluation parameters");
+  }
+  std::memcpy(&count, bytes + sizeof(binary_magic), sizeof(count));
+  if (count != parameter_names.size()) {
+    throw std::invalid_argument("invalid evaluation parameters");
+  }
+
+  evaluation_parameters parameters = default_evaluation_parameters;
+  const unsigned char* value = bytes + sizeof(binary_magic) + sizeof(count);
+
+  for (const auto& name : parameter_names) {
+    std::memcpy(&(parameters.*name.second), value, sizeof(short));
+    value += sizeof(short);
+  }
+  set_parameters(piece_values_of(parameters), lazy_margin_of(parameters));
+}
+
+void position_value::convert_parameters(std::istream& text,
+                                        std::ostream& binary)
+{
+  evaluation_parameters parameters = parse_parameters(text);
+  uint32_t count = uint32_t(parameter_names.size());
+
+  binary.write(binary_magic, sizeof(binary_magic));
+  binary.write(reinterpret_cast<const char*>(&count), sizeof(count));
+  for (const auto& name : parameter_names) {
+    binary.write(reinterpret_cast<const char*>(&(parameters.*name.second)),
+                 sizeof(short));
+  }
+}
+
+void position_value::initialize_lookup_tables(const string& path)
+{
+  std::ifstream file(path, std::ios::binary);
+
+  if (not file) {
+    throw std::runtime_error("unable to open " + path);
+  }
+
+  std::string contents((std::istreambuf_iterator<char>(file)),
+                       std::istreambuf_iterator<char>());
+
+  if (is_binary(contents.data(), contents.size())) {
+    initialize_lookup_tables(contents.data(), contents.size());
+  }
+  else {
+    std::istringstream text(contents);
+    initialize_lookup_tables(text);
+  }
+}
+
+/* The material, counted on the piece maps, and the running {{{
+   piece-square score kept by the position -- no need to look
+   at each square. The midgame and endgame piece-square values are
+   interpolated by the game phase, also kept by the position.
+}}}*/
+position_value::position_value(const ::kator::position& position):
+  internal(position.piece_square_score().tapered(
+             std::min(position.game_phase(), max_game_phase),
+             max_game_phase))
+{
+  for (unsigned square = pawn; square < piece_array_size; ++square) {
+    internal += piece_values[square] * position.map_of(square).popcnt();
   }
 }
 
 } /* namespace kator::engine */
+
+const psq_table piece_square_table =
+  engine::psq_table_of(std::make_index_sequence<piece_array_size>());
 } /* namespace kator */
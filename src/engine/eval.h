@@ -5,7 +5,9 @@
     The rest of the static evaluation happens in the
     eval function, either using an already computed
     material value ( intended for use during search ),
-    or from scratch ( intended for use in business logic )
+    or from scratch ( intended for use in business logic ).
+    The piece-square values are summed incrementally by the
+    position itself, see chess/piece_square.h
 }}}*/
 
 #ifndef KATOR_ENGINE_EVAL_H
@@ -19,6 +21,7 @@
 
 #include "chess/chess.h"
 #include "chess/move.h"
+#include "chess/piece_square.h"
 
 namespace kator
 {
@@ -40,9 +43,14 @@ private:
 
   static std::array<short, piece_array_size> piece_values;
   static move::change_array_t<short> move_change_table;
+  static psq_score lazy_margin;
+  static unsigned parameter_generation;
 
   static constexpr int max = (1 << value_bits) - 1;
 
+  static void set_parameters(const std::array<short, piece_array_size>&,
+                             psq_score lazy_margin);
+
 public:
 
   position_value(square piece):
@@ -163,13 +171,40 @@ public:
     internal += move_change_table[move.change_index()];
   }
 
-  /* Setting up all the constants used during evaluation.
+  /* How far the complete evaluation of a position can be from
+     the material and piece-square score, see engine/evaluator.h
+   */
+  static psq_score get_lazy_margin()
+  {
+    return lazy_margin;
+  }
+
+  /* Changed by every load of the parameters, values computed with
+     the previous ones are to be forgotten, see engine/evaluator.h
+   */
+  static unsigned get_parameter_generation()
+  {
+    return parameter_generation;
+  }
+
+  /* The constants used during evaluation are compiled in, these
+     override them using a configuration file.
      Not thread-safe, but good enough for Kator.
+     Throws std::invalid_argument on a malformed line, and
+     std::runtime_error if the file can not be opened.
    */
-  static void default_initialize_lookup_tables();
   static void initialize_lookup_tables(const std::string& path);
   static void initialize_lookup_tables(std::istream&);
 
+  /* The same, from the binary format written by convert_parameters,
+     e.g. a file mapped into memory. The path based variant above
+     accepts both formats. Cheap enough to be called for each set of
+     parameters tried while tuning.
+     Throws std::invalid_argument on malformed data.
+   */
+  static void initialize_lookup_tables(const void* data, size_t size);
+  static void convert_parameters(std::istream& text, std::ostream& binary);
+
 }; // class position_value
 
 constexpr position_value positive_infinite = position_value::infinite_value();
@@ -0,0 +1,55 @@
+
+#include "eval_cache.h"
+
+namespace kator
+{
+namespace engine
+{
+
+constexpr unsigned eval_cache::default_log2_size;
+constexpr uint64_t eval_cache::value_mask;
+
+eval_cache::eval_cache(unsigned log2_size):
+  entries(size_t(1) << log2_size),
+  mask((uint64_t(1) << log2_size) - 1),
+  hits(0),
+  misses(0)
+{
+  ASSUME(log2_size > 0 and log2_size <= 16);
+  clear();
+}
+
+/* An empty entry matches only hashes with the upper 48 bits {{{
+   all zero, and a null value -- just as likely as any other
+   collision.
+}}}*/
+void eval_cache::clear()
+{
+  for (auto& entry : entries) {
+    entry = 0;
+  }
+  hits = 0;
+  misses = 0;
+}
+
+bool eval_cache::probe(zobrist_hash key, position_value& value)
+{
+  uint64_t entry = entries[key.get_value() & mask];
+
+  if (((entry ^ key.get_value()) & compl value_mask) == 0) {
+    ++hits;
+    value = position_value::create_from_int(int16_t(entry & value_mask));
+    return true;
+  }
+  ++misses;
+  return false;
+}
+
+void eval_cache::store(zobrist_hash key, position_value value)
+{
+  entries[key.get_value() & mask] = (key.get_value() & compl value_mask)
+                                    | uint16_t(value.as_short());
+}
+
+} /* namespace kator::engine */
+} /* namespace kator */
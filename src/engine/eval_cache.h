@@ -0,0 +1,63 @@
+
+#ifndef KATOR_ENGINE_EVAL_CACHE_H
+#define KATOR_ENGINE_EVAL_CACHE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "eval.h"
+#include "chess/zobrist_hash.h"
+
+namespace kator
+{
+namespace engine
+{
+
+/* Static evaluations of recently seen positions, of a search thread. {{{
+   The same position is often evaluated more than once: after
+   transpositions with not enough depth in the transposition table,
+   in quiescence search, after null moves.
+   Direct-mapped, each entry is a single 64 bit word: the upper bits
+   of the zobrist hash, with the value in the lowest sixteen bits.
+   The lower bits of the hash are implied by the index of the entry.
+   The constructor expects the base two logarithm of the entry count,
+   at most sixteen, so no bit of the hash is left unchecked.
+}}}*/
+class eval_cache
+{
+public:
+
+  static constexpr unsigned default_log2_size = 16;
+
+  explicit eval_cache(unsigned log2_size = default_log2_size);
+
+  bool probe(zobrist_hash, position_value&);
+  void store(zobrist_hash, position_value);
+
+  void clear();
+
+  unsigned long hit_count() const noexcept
+  {
+    return hits;
+  }
+
+  unsigned long miss_count() const noexcept
+  {
+    return misses;
+  }
+
+private:
+
+  std::vector<uint64_t> entries;
+  uint64_t mask;
+  unsigned long hits;
+  unsigned long misses;
+
+  static constexpr uint64_t value_mask = 0xffff;
+
+}; /* class eval_cache */
+
+} /* namespace kator::engine */
+} /* namespace kator */
+
+#endif /* !defined(KATOR_ENGINE_EVAL_CACHE_H) */
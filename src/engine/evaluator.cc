@@ -0,0 +1,278 @@
+
+#include "evaluator.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace kator
+{
+namespace engine
+{
+
+namespace
+{
+
+/* The shield in front of a king, on the wing the king is on, {{{
+   nothing for a king in the center.
+}}}*/
+int16_t shield_at(const std::array<int16_t, 2>& shields, sq_index king)
+{
+  file king_file = king.file();
+
+  if (king_file == file_a or king_file == file_b or king_file == file_c) {
+    return shields[pawn_entry::queenside];
+  }
+  if (king_file == file_f or king_file == file_g or king_file == file_h) {
+    return shields[pawn_entry::kingside];
+  }
+  return 0;
+}
+
+/* The scale factor of the side ahead, monotonic in the value, {{{
+   thus bounds of the unscaled value are bounds of the scaled one.
+}}}*/
+int scaled(const material_entry& signature, int value)
+{
+  position_player ahead = (value < 0) ? player_opponent : player_to_move;
+
+  return value * signature.scale[offset(ahead)] / material_entry::normal_scale;
+}
+
+/* Per square, in quarters of the units where a pawn is 0x10, {{{
+   in the order of activity_counts::pieces.
+   Attacks on the king zone only matter in the midgame.
+}}}*/
+constexpr std::array<int, 4> mobility_midgame = {{ 2, 4, 4, 1 }};
+constexpr std::array<int, 4> mobility_endgame = {{ 4, 5, 4, 2 }};
+constexpr std::array<int, 4> king_zone_attack_midgame = {{ 8, 4, 8, 12 }};
+
+psq_score activity_terms(const activity_counts& counts)
+{
+  int midgame = 0;
+  int endgame = 0;
+
+  for (unsigned i = 0; i < activity_counts::pieces.size(); ++i) {
+    int mobility = counts.mobility[i] - counts.opponent_mobility[i];
+    int zone_attacks = counts.king_zone_attacks[i]
+                       - counts.opponent_king_zone_attacks[i];
+
+    midgame += mobility_midgame[i] * mobility
+               + king_zone_attack_midgame[i] * zone_attacks;
+    endgame += mobility_endgame[i] * mobility;
+  }
+  return psq_score(midgame / 4, endgame / 4);
+}
+
+// The material and piece-square score, with the material imbalance
+int cheap_score(const ::kator::position& position,
+                const material_entry& signature)
+{
+  return (position_value(position)
+          + position_value::create_from_int(
+              signature.imbalance.tapered(signature.phase, max_game_phase)))
+         .as_int();
+}
+
+} /* anonym namespace */
+
+position_value evaluator::evaluate(const ::kator::position& position)
+{
+  return evaluate(position,
+                  -position_value::infinite_value(),
+                  position_value::infinite_value());
+}
+
+/* Cached values are complete evaluations, while the value returned {{{
+   by a lazy exit is only good for deciding it is outside the window,
+   and is not cached. The network has no cheap stage to exit after.
+}}}*/
+position_value evaluator::evaluate(const ::kator::position& position,
+                                   position_value alpha,
+                                   position_value beta)
+{
+  position_value value = position_value::null_value();
+
+  forget_stale_values();
+  if (cache.probe(position.get_zhash(), value)) {
+    return value;
+  }
+
+  if (const nnue_network* network = nnue_network::active()) {
+    value = network->evaluate(position);
+    cache.store(position.get_zhash(), value);
+    return value;
+  }
+
+  const material_entry& signature = material.probe(position);
+
+  if (signature.endgame != nullptr) {
+    value = signature.endgame(position, signature.strong_side);
+    cache.store(position.get_zhash(), value);
+    return value;
+  }
+
+  unsigned phase = signature.phase;
+  int cheap = cheap_score(position, signature);
+  int margin = position_value::get_lazy_margin().tapered(phase,
+                                                         max_game_phase);
+
+  if (scaled(signature, cheap + margin) < alpha.as_int()
+      or scaled(signature, cheap - margin) > beta.as_int()) {
+    ++lazy_exits;
+    return position_value::create_from_int(scaled(signature, cheap));
+  }
+
+  ++full_evaluations;
+  value = position_value::create_from_int(scaled(signature,
+      cheap + positional_terms(position, phase, count_activity(position))));
+  cache.store(position.get_zhash(), value);
+  return value;
+}
+
+position_value evaluator::evaluate(const ::kator::position& position,
+                                   const nnue_accumulator& accumulator)
+{
+  const nnue_network* network = nnue_network::active();
+
+  if (network == nullptr) {
+    return evaluate(position);
+  }
+
+  position_value value = position_value::null_value();
+
+  forget_stale_values();
+  if (not cache.probe(position.get_zhash(), value)) {
+    value = network->evaluate(accumulator);
+    cache.store(position.get_zhash(), value);
+  }
+  return value;
+}
+
+/* The terms skipped by a lazy exit -- their sum is expected to be {{{
+   within the lazy margin.
+}}}*/
+int evaluator::positional_terms(const ::kator::position& position,
+                                unsigned phase,
+                                const activity_counts& activity)
+{
+  const pawn_entry& pawn_structure = pawns.probe(position);
+
+  int shield = shield_at(pawn_structure.shields, position.king_index())
+               - shield_at(pawn_structure.opponent_shields,
+                           position.opponent_king_index());
+  psq_score terms = pawn_structure.score + psq_score(shield, 0)
+                    + activity_terms(activity);
+
+  return terms.tapered(phase, max_game_phase);
+}
+
+/* The positions are taken in groups, the attack maps of a group {{{
+   are counted together, one position in each lane of the vectors,
+   see count_activity. The last group is padded with repeating the
+   last position. Neither the cache nor the lazy exits are used,
+   the positions are expected to be unrelated.
+}}}*/
+void evaluator::evaluate_batch(const ::kator::position* const* positions,
+                               size_t count,
+                               position_value* values)
+{
+  constexpr size_t group_size = activity_counts::batch_size;
+
+  forget_stale_values();
+  for (size_t first = 0; first < count; first += group_size) {
+    const ::kator::position* group[group_size];
+    activity_counts activity[group_size];
+    size_t size = std::min(group_size, count - first);
+
+    for (size_t i = 0; i < group_size; ++i) {
+      group[i] = positions[first + std::min(i, size - 1)];
+    }
+    if (nnue_network::active() == nullptr) {
+      count_activity(group, activity);
+    }
+    for (size_t i = 0; i < size; ++i) {
+      values[first + i] = evaluate_complete(*group[i], activity[i]);
+    }
+  }
+}
+
+position_value
+evaluator::evaluate_complete(const ::kator::position& position,
+                             const activity_counts& activity)
+{
+  if (const nnue_network* network = nnue_network::active()) {
+    return network->evaluate(position);
+  }
+
+  const material_entry& signature = material.probe(position);
+
+  if (signature.endgame != nullptr) {
+    return signature.endgame(position, signature.strong_side);
+  }
+
+  ++full_evaluations;
+  return position_value::create_from_int(scaled(signature,
+      cheap_score(position, signature)
+      + positional_terms(position, signature.phase, activity)));
+}
+
+/* The material table holds scale factors computed from the piece {{{
+   values, the cache holds complete evaluations -- both are stale
+   after the parameters change.
+}}}*/
+void evaluator::forget_stale_values()
+{
+  unsigned generation = position_value::get_parameter_generation();
+
+  if (generation != parameter_generation) {
+    pawns.clear();
+    material.clear();
+    cache.clear();
+    parameter_generation = generation;
+  }
+}
+
+void evaluator::clear()
+{
+  pawns.clear();
+  material.clear();
+  cache.clear();
+  lazy_exits = 0;
+  full_evaluations = 0;
+}
+
+/* Each thread evaluates a contiguous range, with its own evaluator, {{{
+   as evaluators are not to be shared between threads.
+}}}*/
+void evaluate_batch(const ::kator::position* const* positions,
+                    size_t count,
+                    position_value* values,
+                    unsigned thread_count)
+{
+  if (thread_count == 0) {
+    thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+
+  size_t range = (count + thread_count - 1) / thread_count;
+  std::vector<std::thread> threads;
+
+  for (size_t first = range; first < count; first += range) {
+    size_t size = std::min(range, count - first);
+
+    threads.emplace_back([=]() {
+      evaluator eval;
+      eval.evaluate_batch(positions + first, size, values + first);
+    });
+  }
+
+  evaluator eval;
+  eval.evaluate_batch(positions, std::min(range, count), values);
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+} /* namespace kator::engine */
+} /* namespace kator */
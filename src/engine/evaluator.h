@@ -0,0 +1,112 @@
+
+#ifndef KATOR_ENGINE_EVALUATOR_H
+#define KATOR_ENGINE_EVALUATOR_H
+
+#include "eval.h"
+#include "pawn_table.h"
+#include "material_table.h"
+#include "eval_cache.h"
+#include "nnue.h"
+#include "activity.h"
+
+namespace kator
+{
+namespace engine
+{
+
+/* The static evaluation used by the search. {{{
+   Each search thread owns one evaluator, holding the caches of that
+   thread -- nothing in here is shared between threads.
+   The evaluation starts from position_value( const position& ),
+   adding the terms too expensive to compute in every node without
+   caching them, e.g. the pawn structure, or the material signature.
+   Whole evaluations are cached as well.
+
+   The evaluation is staged when a search window is given: when the
+   material and piece-square score is further outside the window
+   than the lazy margin, that score is returned without computing
+   the rest. Such values are only bounds, good for cutoffs.
+   The counters of the cache and of the lazy exits are reset by
+   clear(). The caches are also cleared when the evaluation parameters
+   are loaded again, e.g. by a tuning loop, between two evaluations --
+   see position_value::get_parameter_generation.
+
+   When a neural network is active, it replaces all of the above,
+   except for the cache. The network is looked up at every evaluation,
+   just as search nodes do when keeping the first layer of the network
+   up to date, see the overload taking an nnue_accumulator. Thus the
+   network must not be changed while an evaluation is in progress,
+   and the evaluations cached before a change are only forgotten
+   by clear().
+}}}*/
+class evaluator
+{
+public:
+
+  evaluator() = default;
+  evaluator(const evaluator&) = delete;
+  evaluator& operator= (const evaluator&) = delete;
+
+  position_value evaluate(const ::kator::position&);
+  position_value evaluate(const ::kator::position&,
+                          position_value alpha, position_value beta);
+  position_value evaluate(const ::kator::position&,
+                          const nnue_accumulator&);
+
+  /* Complete evaluations of unrelated positions, see also the {{{
+     multithreaded evaluate_batch function below.
+  }}}*/
+  void evaluate_batch(const ::kator::position* const*, size_t count,
+                      position_value*);
+
+  void clear();
+
+  unsigned long cache_hit_count() const noexcept
+  {
+    return cache.hit_count();
+  }
+
+  unsigned long cache_miss_count() const noexcept
+  {
+    return cache.miss_count();
+  }
+
+  unsigned long lazy_exit_count() const noexcept
+  {
+    return lazy_exits;
+  }
+
+  unsigned long full_evaluation_count() const noexcept
+  {
+    return full_evaluations;
+  }
+
+private:
+
+  int positional_terms(const ::kator::position&, unsigned phase,
+                       const activity_counts&);
+  position_value evaluate_complete(const ::kator::position&,
+                                   const activity_counts&);
+  void forget_stale_values();
+
+  pawn_table pawns;
+  material_table material;
+  eval_cache cache;
+  unsigned parameter_generation = position_value::get_parameter_generation();
+  unsigned long lazy_exits = 0;
+  unsigned long full_evaluations = 0;
+
+}; /* class evaluator */
+
+/* Evaluating many positions, e.g. for tuning, or labelling data. {{{
+   The positions are split evenly among thread_count threads, each
+   using its own evaluator, zero meaning one thread per hardware
+   thread. The calling thread takes the first range.
+}}}*/
+void evaluate_batch(const ::kator::position* const*, size_t count,
+                    position_value*, unsigned thread_count = 1);
+
+} /* namespace kator::engine */
+} /* namespace kator */
+
+#endif /* !defined(KATOR_ENGINE_EVALUATOR_H) */
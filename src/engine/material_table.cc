@@ -0,0 +1,155 @@
+
+#include "material_table.h"
+
+#include <algorithm>
+
+namespace kator
+{
+namespace engine
+{
+
+constexpr unsigned material_table::default_log2_size;
+constexpr uint8_t material_entry::normal_scale;
+
+namespace
+{
+
+// Bishop pair, in units where a pawn is 0x10, see default_values.inc
+constexpr psq_score bishop_pair_bonus(3, 5);
+
+// The key of a board with fifteen kings, never probed
+constexpr uint64_t empty_key = ~UINT64_C(0);
+
+int non_pawn_material(material_key key, position_player player)
+{
+  int sum = 0;
+
+  for (auto type : {piece::rook, piece::bishop, piece::knight, piece::queen}) {
+    sum += int(key.count(make_square(type, player)))
+           * position_value(type).as_int();
+  }
+  return sum;
+}
+
+bool has_only(material_key key, position_player player,
+              unsigned rooks, unsigned bishops, unsigned knights)
+{
+  return key.count(make_square(piece::pawn, player)) == 0
+     and key.count(make_square(piece::queen, player)) == 0
+     and key.count(make_square(piece::rook, player)) == rooks
+     and key.count(make_square(piece::bishop, player)) == bishops
+     and key.count(make_square(piece::knight, player)) == knights;
+}
+
+bool is_bare_king(material_key key, position_player player)
+{
+  return has_only(key, player, 0, 0, 0);
+}
+
+endgame_function endgame_of(material_key key, position_player strong_side)
+{
+  if (not is_bare_king(key, opponent_of(strong_side))) {
+    return nullptr;
+  }
+  if (has_only(key, strong_side, 1, 0, 0)) {
+    return evaluate_krk;
+  }
+  if (has_only(key, strong_side, 0, 1, 1)) {
+    return evaluate_kbnk;
+  }
+  return nullptr;
+}
+
+/* Without pawns, a material advantage of at most a minor piece {{{
+   is rarely enough to win -- and a lone minor piece never is.
+}}}*/
+uint8_t scale_of(material_key key, position_player player)
+{
+  if (key.count(make_square(piece::pawn, player)) != 0) {
+    return material_entry::normal_scale;
+  }
+
+  int ours = non_pawn_material(key, player);
+  int theirs = non_pawn_material(key, opponent_of(player));
+  int minor = position_value(bishop).as_int();
+
+  if (ours - theirs > minor) {
+    return material_entry::normal_scale;
+  }
+  if (ours < position_value(rook).as_int()) {
+    return 0;
+  }
+  return (theirs <= minor) ? 4 : 14;
+}
+
+unsigned phase_of(material_key key)
+{
+  unsigned phase = 0;
+
+  for (auto type : {piece::rook, piece::bishop, piece::knight, piece::queen}) {
+    phase += phase_weight(type) * (key.count(make_square(type, player_to_move))
+                                   + key.count(make_square(type,
+                                                           player_opponent)));
+  }
+  return std::min(phase, max_game_phase);
+}
+
+} /* anonym namespace */
+
+void evaluate_material(material_key key, material_entry& entry)
+{
+  entry.key = key.get_value();
+  entry.phase = static_cast<uint8_t>(phase_of(key));
+
+  entry.imbalance = psq_score();
+  if (key.count(bishop) >= 2) {
+    entry.imbalance += bishop_pair_bonus;
+  }
+  if (key.count(opponent_bishop) >= 2) {
+    entry.imbalance -= bishop_pair_bonus;
+  }
+
+  entry.scale[offset(player_to_move)] = scale_of(key, player_to_move);
+  entry.scale[offset(player_opponent)] = scale_of(key, player_opponent);
+
+  entry.strong_side = player_to_move;
+  entry.endgame = endgame_of(key, player_to_move);
+  if (entry.endgame == nullptr) {
+    entry.strong_side = player_opponent;
+    entry.endgame = endgame_of(key, player_opponent);
+  }
+}
+
+material_table::material_table(unsigned log2_size):
+  entries(size_t(1) << log2_size),
+  shift(64 - log2_size)
+{
+  ASSUME(log2_size > 0 and log2_size < 64);
+  clear();
+}
+
+void material_table::clear()
+{
+  for (auto& entry : entries) {
+    entry.key = empty_key;
+  }
+}
+
+/* Material keys are far from random, most of their bits are {{{
+   zero, they are multiplied before taking the index from the
+   high bits.
+}}}*/
+const material_entry& material_table::probe(const ::kator::position& position)
+{
+  material_key key = position.get_material_key();
+  uint64_t hash = key.get_value() * UINT64_C(0x9e3779b97f4a7c15);
+  material_entry& entry = entries[hash >> shift];
+
+  if (entry.key != key.get_value()) {
+    evaluate_material(key, entry);
+  }
+  return entry;
+}
+
+} /* namespace kator::engine */
+} /* namespace kator */
@@ -0,0 +1,69 @@
+
+#ifndef KATOR_ENGINE_MATERIAL_TABLE_H
+#define KATOR_ENGINE_MATERIAL_TABLE_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "chess/position.h"
+#include "endgame.h"
+
+namespace kator
+{
+namespace engine
+{
+
+/* What depends only on the count of pieces on the board. {{{
+   The imbalance holds the terms not expressed by the piece values,
+   e.g. the bishop pair, the player to move's terms minus the
+   opponent's.
+   The scale factors are in 64ths, applied to the evaluation when
+   the corresponding player is ahead -- being ahead with e.g. a
+   lone minor piece, and no pawns, is not enough to win.
+   The endgame is a specialized evaluation function, when one
+   is known for the material on the board, or nullptr.
+}}}*/
+struct material_entry
+{
+  uint64_t key;
+  psq_score imbalance;
+  uint8_t phase;
+  std::array<uint8_t, 2> scale;
+  position_player strong_side;
+  endgame_function endgame;
+
+  static constexpr uint8_t normal_scale = 64;
+
+}; /* struct material_entry */
+
+void evaluate_material(material_key, material_entry&);
+
+/* The cached material evaluations of a search thread. {{{
+   There are only a few distinct material configurations in any
+   search, a small table is enough. Just like the pawn_table, it is
+   never shared between threads.
+}}}*/
+class material_table
+{
+public:
+
+  static constexpr unsigned default_log2_size = 10;
+
+  explicit material_table(unsigned log2_size = default_log2_size);
+
+  const material_entry& probe(const ::kator::position&);
+
+  void clear();
+
+private:
+
+  std::vector<material_entry> entries;
+  unsigned shift;
+
+}; /* class material_table */
+
+} /* namespace kator::engine */
+} /* namespace kator */
+
+#endif /* !defined(KATOR_ENGINE_MATERIAL_TABLE_H) */
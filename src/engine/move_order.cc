@@ -0,0 +1,160 @@
+
+#include "move_order.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "platform/vectors.h"
+
+namespace kator
+{
+namespace engine
+{
+
+constexpr int16_t history_table::max_value;
+constexpr size_t scored_move_list::capacity;
+
+void history_table::reward(move move, unsigned depth) noexcept
+{
+  int16_t& value = values[index_of(move)];
+  int bonus = (depth < 64) ? static_cast<int>(depth * depth) : max_value;
+
+  if (value + bonus > max_value) {
+    for (auto& item : values) {
+      item /= 2;
+    }
+  }
+  value = static_cast<int16_t>(std::min(value + bonus, int(max_value)));
+}
+
+namespace
+{
+
+/* Small per piece values, four bits each, looked up with a variable {{{
+   shift of a 64 bit constant by four times the piece -- a table lookup
+   that can be done in each lane of a vector at once.
+}}}*/
+constexpr uint64_t nibble(piece piece, unsigned value)
+{
+  return uint64_t(value) << (offset(piece) * 4);
+}
+
+/* Both for victims and attackers, the king is zero as an attacker, {{{
+   it can only capture undefended pieces.
+}}}*/
+constexpr uint64_t piece_values =
+  nibble(piece::pawn, 1) | nibble(piece::knight, 3) | nibble(piece::bishop, 3)
+  | nibble(piece::rook, 5) | nibble(piece::queen, 9);
+
+// Underpromotions to a rook or bishop are ordered among the quiet moves
+constexpr uint64_t promotion_gains =
+  nibble(piece::knight, 2) | nibble(piece::queen, 8);
+
+constexpr uint64_t promotion_types = uint64_t(1) << (move::promotion * 4);
+
+constexpr uint64_t tactical_base = 0x4000;
+
+/* The kind of a move, in the bits of a vector lane: {{{
+   move type: 0-2, result piece: 3-7, captured piece: 8-15
+}}}*/
+uint64_t bits_of(move move) noexcept
+{
+  return move.move_type
+         | (offset(move.result()) << 3)
+         | (offset(move.captured()) << 8);
+}
+
+/* Scoring four moves at once, zero for quiet moves. {{{
+   The score of a capture or promotion is the material gained
+   times 16, minus the value of the piece moving, plus tactical_base
+   to lift it above any history score.
+}}}*/
+u64x4 score_tactical(u64x4 raw) noexcept
+{
+  const u64x4 four = broadcast_u64x4(4);
+  const u64x4 nibble_mask = broadcast_u64x4(0xf);
+  const u64x4 one = broadcast_u64x4(1);
+
+  u64x4 captured = raw >> broadcast_u64x4(8);
+  u64x4 result = (raw >> broadcast_u64x4(3)) & broadcast_u64x4(0x1f);
+  u64x4 type = raw & broadcast_u64x4(7);
+
+  u64x4 is_promotion =
+    (broadcast_u64x4(promotion_types) >> (type << broadcast_u64x4(2))) & one;
+  u64x4 promotion_mask = broadcast_u64x4(0) - is_promotion;
+
+  u64x4 gain =
+    ((broadcast_u64x4(piece_values) >> (captured << broadcast_u64x4(2)))
+       & nibble_mask)
+    + ((broadcast_u64x4(promotion_gains) >> (result << broadcast_u64x4(2)))
+         & nibble_mask & promotion_mask);
+
+  u64x4 attacker =
+    (broadcast_u64x4(piece_values) >> (result << broadcast_u64x4(2)))
+      & nibble_mask;
+  attacker = (attacker & compl promotion_mask) | (one & promotion_mask);
+
+  // One for any non-zero gain, which is at most 17
+  u64x4 is_tactical = (gain + broadcast_u64x4(31)) >> broadcast_u64x4(5);
+  u64x4 tactical_mask = broadcast_u64x4(0) - is_tactical;
+
+  u64x4 score = broadcast_u64x4(tactical_base) + (gain << four) - attacker;
+
+  return score & tactical_mask;
+}
+
+} /* anonym namespace */
+
+size_t scored_move_list::generate(const ::kator::position& position,
+                                  const history_table& history) noexcept
+{
+  size = generate_legal_moves(position, moves.data(), moves.size());
+  next = 0;
+  score_moves(history);
+  return size;
+}
+
+void scored_move_list::score_moves(const history_table& history) noexcept
+{
+  for (size_t i = size; i < capacity and i % 4 != 0; ++i) {
+    moves[i] = move::null();
+  }
+
+  for (size_t i = 0; i < size; i += 4) {
+    u64x4 score = score_tactical(make_u64x4(bits_of(moves[i]),
+                                            bits_of(moves[i + 1]),
+                                            bits_of(moves[i + 2]),
+                                            bits_of(moves[i + 3])));
+
+    for (unsigned lane = 0; lane < 4; ++lane) {
+      scores[i + lane] = static_cast<int16_t>(lane_of(score, lane));
+    }
+  }
+
+  // The history table lookups are not vectorized
+  for (size_t i = 0; i < size; ++i) {
+    if (scores[i] == 0) {
+      scores[i] = history.value_of(moves[i]);
+    }
+  }
+}
+
+move scored_move_list::pick_next() noexcept
+{
+  ASSUME(next < size);
+
+  size_t best = next;
+
+  for (size_t i = next + 1; i < size; ++i) {
+    if (scores[i] > scores[best]) {
+      best = i;
+    }
+  }
+
+  std::swap(moves[next], moves[best]);
+  std::swap(scores[next], scores[best]);
+  return moves[next++];
+}
+
+} /* namespace kator::engine */
+} /* namespace kator */
@@ -0,0 +1,120 @@
+
+#ifndef KATOR_ENGINE_MOVE_ORDER_H
+#define KATOR_ENGINE_MOVE_ORDER_H
+
+#include <array>
+#include <cstdint>
+
+#include "chess/move_list.h"
+
+namespace kator
+{
+namespace engine
+{
+
+/* History heuristic scores of quiet moves, indexed by from and to. {{{
+   The scores are kept below the scores of captures and promotions
+   by scored_move_list, when one grows too large, all of them are
+   halved.
+}}}*/
+class history_table
+{
+public:
+
+  static constexpr int16_t max_value = 0x3fff;
+
+  history_table() noexcept
+  {
+    clear();
+  }
+
+  void clear() noexcept
+  {
+    values.fill(0);
+  }
+
+  int16_t value_of(move move) const noexcept
+  {
+    return values[index_of(move)];
+  }
+
+  /* A quiet move causing a cutoff at depth plies from the leaves */
+  void reward(move, unsigned depth) noexcept;
+
+private:
+
+  std::array<int16_t, 64 * 64> values;
+
+  static size_t index_of(move move) noexcept
+  {
+    return move.from.offset() * 64 + move.to.offset();
+  }
+
+}; /* class history_table */
+
+/* The legal moves of a position, with their ordering scores. {{{
+   Stored as a structure of arrays -- the moves in one array, the scores
+   in another one -- thus the scores can be computed in vector registers,
+   several moves at once. Captures and promotions are scored by
+   MVV-LVA ( most valuable victim, least valuable attacker ) above all
+   quiet moves, which are scored by the history heuristic.
+   The moves are picked in the order of their scores, the best remaining
+   move is selected when needed -- after a cutoff, the rest of the list
+   is never sorted.
+}}}*/
+class scored_move_list
+{
+public:
+
+  scored_move_list() noexcept:
+    size(0),
+    next(0)
+  {
+  }
+
+  /* Generating, and scoring all the legal moves, returns the count */
+  size_t generate(const ::kator::position&, const history_table&) noexcept;
+
+  size_t count() const noexcept
+  {
+    return size;
+  }
+
+  move operator[] (size_t index) const noexcept
+  {
+    ASSUME(index < size);
+    return moves[index];
+  }
+
+  int16_t score(size_t index) const noexcept
+  {
+    ASSUME(index < size);
+    return scores[index];
+  }
+
+  bool has_next() const noexcept
+  {
+    return next < size;
+  }
+
+  /* The move with the highest score among those not picked yet */
+  move pick_next() noexcept;
+
+private:
+
+  // Room for whole vectors of moves at the end of the list
+  static constexpr size_t capacity = (move_list::max_size + 3) & ~size_t(3);
+
+  alignas(32) std::array<move, capacity> moves;
+  alignas(32) std::array<int16_t, capacity> scores;
+  size_t size;
+  size_t next;
+
+  void score_moves(const history_table&) noexcept;
+
+}; /* class scored_move_list */
+
+} /* namespace kator::engine */
+} /* namespace kator */
+
+#endif /* !defined(KATOR_ENGINE_MOVE_ORDER_H) */
@@ -0,0 +1,277 @@
+
+#include "nnue.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace kator
+{
+namespace engine
+{
+
+constexpr unsigned nnue_accumulator::width;
+constexpr unsigned nnue_network::width;
+constexpr unsigned nnue_network::king_feature_count;
+constexpr unsigned nnue_network::feature_count;
+constexpr unsigned nnue_network::hidden_width;
+constexpr int nnue_network::output_divisor;
+
+namespace
+{
+
+typedef std::array<int16_t, nnue_network::width> half_accumulator;
+
+std::unique_ptr<const nnue_network> active_network;
+
+constexpr char magic[8] = { 'K', 'A', 'T', 'O', 'R', 'N', 'N', '1' };
+
+/* Twice the index of the piece type among the five types {{{
+   with features, indexed by square, -1 for kings, and empty squares.
+}}}*/
+constexpr std::array<int, piece_array_size> kind_base = {{
+  -1, -1, 0, 0, 2, 2, -1, -1, 4, 4, 6, 6, 8, 8
+}};
+
+/* The player's view of the board: the opponent sees it flipped, {{{
+   and owns the pieces of the other color.
+}}}*/
+unsigned feature_index(position_player player, sq_index king,
+                       unsigned square, sq_index index)
+{
+  unsigned flip_mask = (player == player_to_move) ? 0 : 0x38;
+  unsigned kind = unsigned(kind_base[square]) + ((square & 1) ^ offset(player));
+
+  return (king.offset() ^ flip_mask) * nnue_network::king_feature_count
+         + kind * 64 + (index.offset() ^ flip_mask);
+}
+
+sq_index king_of(const ::kator::position& position, position_player player)
+{
+  return (player == player_to_move)
+         ? position.king_index()
+         : position.opponent_king_index();
+}
+
+void add_row(half_accumulator& accumulator, const int16_t* row)
+{
+  for (unsigned i = 0; i < nnue_network::width; ++i) {
+    accumulator[i] += row[i];
+  }
+}
+
+void subtract_row(half_accumulator& accumulator, const int16_t* row)
+{
+  for (unsigned i = 0; i < nnue_network::width; ++i) {
+    accumulator[i] -= row[i];
+  }
+}
+
+int16_t clipped(int value)
+{
+  return static_cast<int16_t>(std::min(std::max(value, 0), 127));
+}
+
+template<typename type>
+void read_array(std::istream& stream, type* destination, size_t count)
+{
+  stream.read(reinterpret_cast<char*>(destination),
+              std::streamsize(count * sizeof(type)));
+  if (not stream) {
+    throw std::runtime_error("truncated network file");
+  }
+}
+
+uint32_t read_uint32(std::istream& stream)
+{
+  uint32_t value;
+
+  read_array(stream, &value, 1);
+  return value;
+}
+
+} /* anonym namespace */
+
+nnue_network::nnue_network():
+  feature_weights(size_t(feature_count) * width),
+  hidden_weights(size_t(hidden_width) * 2 * width)
+{
+}
+
+std::unique_ptr<nnue_network> nnue_network::load(std::istream& stream)
+{
+  char header[sizeof(magic)];
+
+  read_array(stream, header, sizeof(header));
+  if (std::memcmp(header, magic, sizeof(magic)) != 0) {
+    throw std::runtime_error("not a network file");
+  }
+  if (read_uint32(stream) != feature_count
+      or read_uint32(stream) != width
+      or read_uint32(stream) != hidden_width) {
+    throw std::runtime_error("unsupported network dimensions");
+  }
+
+  std::unique_ptr<nnue_network> network(new nnue_network);
+
+  read_array(stream, network->feature_weights.data(),
+             network->feature_weights.size());
+  read_array(stream, network->feature_biases.data(), width);
+  read_array(stream, network->hidden_weights.data(),
+             network->hidden_weights.size());
+  read_array(stream, network->hidden_biases.data(), hidden_width);
+  read_array(stream, network->output_weights.data(), hidden_width);
+  read_array(stream, &network->output_bias, 1);
+  return network;
+}
+
+std::unique_ptr<nnue_network> nnue_network::load(const std::string& path)
+{
+  std::ifstream file(path, std::ios::binary);
+
+  if (not file) {
+    throw std::runtime_error("unable to open " + path);
+  }
+  return load(file);
+}
+
+void nnue_network::set_active(std::unique_ptr<const nnue_network> network)
+{
+  active_network = std::move(network);
+}
+
+const nnue_network* nnue_network::active() noexcept
+{
+  return active_network.get();
+}
+
+/* The loops over the int16 lanes are vectorized for the instruction {{{
+   set of each clone, e.g. AVX2 in the haswell one, when building a
+   portable binary.
+}}}*/
+KATOR_MULTIVERSION
+void nnue_network::refresh_half(const ::kator::position& position,
+                                position_player player,
+                                half_accumulator& accumulator) const noexcept
+{
+  sq_index king = king_of(position, player);
+
+  accumulator = feature_biases;
+  for (unsigned square = pawn; square < piece_array_size; ++square) {
+    if (kind_base[square] < 0) {
+      continue;
+    }
+    for (auto index : position.map_of(square)) {
+      add_row(accumulator, &feature_weights[size_t(width)
+                  * feature_index(player, king, square, index)]);
+    }
+  }
+}
+
+void nnue_network::refresh(const ::kator::position& position,
+                           nnue_accumulator& accumulator) const noexcept
+{
+  refresh_half(position, player_to_move, accumulator.values[0]);
+  refresh_half(position, player_opponent, accumulator.values[1]);
+}
+
+/* The pieces of the child are compared to those of the parent, {{{
+   square type by square type, on the parent's side of the board.
+   This catches everything a move can change -- captures, promotions,
+   the rook of a castling, the pawn taken en passant -- without looking
+   at the move itself. The kings are not among the features, only the
+   half of the player who moved their king is computed from scratch.
+}}}*/
+KATOR_MULTIVERSION
+void nnue_network::update(const ::kator::position& parent,
+                          const nnue_accumulator& parent_accumulator,
+                          const ::kator::position& child,
+                          nnue_accumulator& child_accumulator) const noexcept
+{
+  bool king_moved = parent.king_index()
+                    != child.opponent_king_index().flipped();
+
+  child_accumulator.values[0] = parent_accumulator.values[1];
+  if (king_moved) {
+    refresh_half(child, player_opponent, child_accumulator.values[1]);
+  }
+  else {
+    child_accumulator.values[1] = parent_accumulator.values[0];
+  }
+
+  for (unsigned square = pawn; square < piece_array_size; ++square) {
+    if (kind_base[square] < 0) {
+      continue;
+    }
+
+    bitboard before = parent.map_of(square);
+    bitboard after = flip(child.map_of(square ^ 1));
+
+    for (auto index : before & compl after) {
+      subtract_row(child_accumulator.values[0], &feature_weights[size_t(width)
+          * feature_index(player_opponent, parent.opponent_king_index(),
+                          square, index)]);
+      if (not king_moved) {
+        subtract_row(child_accumulator.values[1], &feature_weights[size_t(width)
+            * feature_index(player_to_move, parent.king_index(),
+                            square, index)]);
+      }
+    }
+    for (auto index : after & compl before) {
+      add_row(child_accumulator.values[0], &feature_weights[size_t(width)
+          * feature_index(player_opponent, parent.opponent_king_index(),
+                          square, index)]);
+      if (not king_moved) {
+        add_row(child_accumulator.values[1], &feature_weights[size_t(width)
+            * feature_index(player_to_move, parent.king_index(),
+                            square, index)]);
+      }
+    }
+  }
+}
+
+KATOR_MULTIVERSION
+position_value
+nnue_network::evaluate(const nnue_accumulator& accumulator) const noexcept
+{
+  std::array<int16_t, 2 * width> input;
+  std::array<int32_t, hidden_width> hidden;
+
+  for (unsigned i = 0; i < width; ++i) {
+    input[i] = clipped(accumulator.values[0][i]);
+    input[width + i] = clipped(accumulator.values[1][i]);
+  }
+
+  for (unsigned output = 0; output < hidden_width; ++output) {
+    const int16_t* row = &hidden_weights[size_t(output) * 2 * width];
+    int32_t sum = hidden_biases[output];
+
+    for (unsigned i = 0; i < 2 * width; ++i) {
+      sum += int32_t(row[i]) * input[i];
+    }
+    hidden[output] = clipped(sum >> 6);
+  }
+
+  int32_t sum = output_bias;
+  for (unsigned i = 0; i < hidden_width; ++i) {
+    sum += int32_t(output_weights[i]) * hidden[i];
+  }
+
+  int limit = position_value::infinite_value().as_int() - 1;
+  int value = std::min(std::max(sum / output_divisor, -limit), limit);
+
+  return position_value::create_from_int(value);
+}
+
+position_value
+nnue_network::evaluate(const ::kator::position& position) const noexcept
+{
+  nnue_accumulator accumulator;
+
+  refresh(position, accumulator);
+  return evaluate(accumulator);
+}
+
+} /* namespace kator::engine */
+} /* namespace kator */
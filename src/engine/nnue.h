@@ -0,0 +1,116 @@
+
+#ifndef KATOR_ENGINE_NNUE_H
+#define KATOR_ENGINE_NNUE_H
+
+#include <array>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "eval.h"
+#include "chess/position.h"
+
+namespace kator
+{
+namespace engine
+{
+
+/* The first layer of the network, for both players. {{{
+   Index zero is the player to move, index one is the opponent, as
+   everywhere else. Making a move flips the board, and the two halves
+   swap places as well -- see nnue_network::update.
+}}}*/
+struct alignas(32) nnue_accumulator
+{
+  static constexpr unsigned width = 128;
+
+  std::array<std::array<int16_t, width>, 2> values;
+
+}; /* struct nnue_accumulator */
+
+/* An alternative to the handcrafted evaluation, a small neural network. {{{
+   Inputs: for each player, the king's square, combined with the
+   square and kind of every other piece ( five types, two owners ),
+   seen from that player's side of the board -- 64 * 640 features, of
+   which only about thirty are set at a time.
+   The first layer is the sum of the weight rows of the features set,
+   kept in an nnue_accumulator. A move changes only a few features, so
+   the accumulator of a child position is computed from the parent's,
+   except for the half of the player who moved their king.
+   The rest of the network is small: the two halves of the accumulator
+   ( the player to move's first ) clipped to [0, 127], an affine layer
+   of 32 outputs, clipped again, and the output, in position_value units.
+   All arithmetic is on int16 lanes, summed in int32 -- the loops are
+   written for the compiler to vectorize, for whichever instruction set
+   it targets.
+
+   The weights are loaded from a file at runtime, see load. The
+   evaluator uses the active network, when there is one.
+}}}*/
+class nnue_network
+{
+public:
+
+  static constexpr unsigned width = nnue_accumulator::width;
+  static constexpr unsigned king_feature_count = 64 * 10;
+  static constexpr unsigned feature_count = 64 * king_feature_count;
+  static constexpr unsigned hidden_width = 32;
+  static constexpr int output_divisor = 256;
+
+  /* The file starts with the eight bytes "KATORNN1", followed by {{{
+     the uint32 values feature_count, width, hidden_width. Then the
+     parameters, in the byte order of the host:
+       int16 first layer weights [feature_count][width]
+       int16 first layer biases [width]
+       int16 hidden layer weights [hidden_width][2 * width]
+       int32 hidden layer biases [hidden_width]
+       int16 output weights [hidden_width]
+       int32 output bias
+     Throws std::runtime_error on a malformed file.
+  }}}*/
+  static std::unique_ptr<nnue_network> load(std::istream&);
+  static std::unique_ptr<nnue_network> load(const std::string& path);
+
+  /* The network used by evaluators and search nodes from now on. {{{
+     Not thread-safe, meant to be called before any search is started,
+     the previous network is destroyed.
+     A nullptr switches back to the handcrafted evaluation.
+  }}}*/
+  static void set_active(std::unique_ptr<const nnue_network>);
+  static const nnue_network* active() noexcept;
+
+  void refresh(const ::kator::position&, nnue_accumulator&) const noexcept;
+
+  /* Computing the accumulator of a child position, from the features {{{
+     that differ between the parent and the child.
+  }}}*/
+  void update(const ::kator::position& parent,
+              const nnue_accumulator& parent_accumulator,
+              const ::kator::position& child,
+              nnue_accumulator& child_accumulator) const noexcept;
+
+  position_value evaluate(const nnue_accumulator&) const noexcept;
+  position_value evaluate(const ::kator::position&) const noexcept;
+
+private:
+
+  nnue_network();
+
+  std::vector<int16_t> feature_weights;
+  std::array<int16_t, width> feature_biases;
+  std::vector<int16_t> hidden_weights;
+  std::array<int32_t, hidden_width> hidden_biases;
+  std::array<int16_t, hidden_width> output_weights;
+  int32_t output_bias;
+
+  void refresh_half(const ::kator::position&, position_player,
+                    std::array<int16_t, width>&) const noexcept;
+
+}; /* class nnue_network */
+
+} /* namespace kator::engine */
+} /* namespace kator */
+
+#endif /* !defined(KATOR_ENGINE_NNUE_H) */
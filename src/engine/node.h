@@ -3,28 +3,52 @@
 #define KATOR_ENGINE_NODE_H
 
 #include "chess/position.h"
-#include "chess/move_list.h"
 #include "eval.h"
+#include "move_order.h"
+#include "nnue.h"
 
 namespace kator
 {
 namespace engine
 {
 
-class node
+/* One frame of the search stack, belonging to a ply of the search. {{{
+   Everything the search needs at a ply is here: the position, its
+   legal moves with their ordering scores, the killer moves, the
+   window, the static evaluation, and the first layer of the active
+   neural network, if any. The frames are allocated once per
+   search thread, see search_stack.h, and are overwritten in place as
+   the search moves along a line -- nothing is allocated while searching.
+   The frames start on cache line boundaries, so the hot members of
+   adjacent plies never share a line.
+}}}*/
+class alignas(cache_line_size) node
 {
 public:
 
   // For creating a root node
-  node(const position&);
+  node(const ::kator::position&);
 
-private:
-
-  position position;
-  move_list moves;
+  ::kator::position position;
+  scored_move_list moves;
   position_value alpha;
   position_value beta;
-  std::array<move, 3> killers;
+  position_value static_value;
+  std::array<packed_move, 3> killers;
+  nnue_accumulator accumulator;
+
+  /* Reusing a frame for a new root, forgetting all the killers */
+  void set_up_root(const ::kator::position&) noexcept;
+
+  /* Making a move in the parent frame's position, with the {{{
+     negated window of the parent. The killers are left intact,
+     as those belong to the ply, not to the position.
+  }}}*/
+  void set_up_child(const node& parent, move) noexcept;
+
+  void generate_moves(const history_table&) noexcept;
+
+private:
 
   node();
 
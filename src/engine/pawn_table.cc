@@ -0,0 +1,149 @@
+
+#include "pawn_table.h"
+
+namespace kator
+{
+namespace engine
+{
+
+constexpr unsigned pawn_table::default_log2_size;
+
+namespace
+{
+
+// Pawn terms, in units where a pawn is 0x10, see default_values.inc
+constexpr psq_score doubled_penalty(-2, -4);
+constexpr psq_score isolated_penalty(-2, -3);
+constexpr psq_score backward_penalty(-2, -2);
+
+// Indexed by the rank, counted from the player's own back rank
+constexpr std::array<psq_score, 8> passed_bonus = {{
+  psq_score(0, 0), psq_score(1, 2), psq_score(1, 2), psq_score(2, 4),
+  psq_score(4, 8), psq_score(7, 14), psq_score(11, 22), psq_score(0, 0)
+}};
+
+constexpr int16_t shield_second_rank = 3;
+constexpr int16_t shield_third_rank = 2;
+
+const bitboard queenside_files = bitboard(file_a) | bitboard(file_b)
+                                 | bitboard(file_c);
+const bitboard kingside_files = bitboard(file_f) | bitboard(file_g)
+                                | bitboard(file_h);
+
+bitboard north_fill(bitboard map)
+{
+  map |= north_of(map);
+  map |= bitboard(map.to_uint64_t() >> 16);
+  map |= bitboard(map.to_uint64_t() >> 32);
+  return map;
+}
+
+bitboard south_fill(bitboard map)
+{
+  map |= south_of(map);
+  map |= bitboard(map.to_uint64_t() << 16);
+  map |= bitboard(map.to_uint64_t() << 32);
+  return map;
+}
+
+bitboard adjacent_files(bitboard files)
+{
+  return bitboard::left_of(files & compl bitboard(file_a))
+         | bitboard::right_of(files & compl bitboard(file_h));
+}
+
+int16_t shield_of(bitboard pawns, bitboard wing)
+{
+  return static_cast<int16_t>(
+      shield_second_rank * (pawns & wing & bitboard(rank_2)).popcnt()
+      + shield_third_rank * (pawns & wing & bitboard(rank_3)).popcnt());
+}
+
+/* The terms of one side's pawns, moving north on the board. {{{
+   The opponent's pawns are evaluated on the flipped board.
+}}}*/
+psq_score side_terms(bitboard pawns, bitboard their_pawns, bitboard& passed)
+{
+  psq_score score;
+  bitboard files = north_fill(pawns) | south_fill(pawns);
+  bitboard their_front_spans = south_fill(south_of(their_pawns));
+
+  bitboard doubled = pawns & north_fill(north_of(pawns));
+  bitboard isolated = pawns & compl adjacent_files(files);
+
+  passed = pawns & compl (their_front_spans
+                          | adjacent_files(their_front_spans));
+
+  // The stop square can not be defended by a pawn, and is attacked
+  bitboard attack_spans = north_fill(bitboard::pawn_attacks(pawns));
+  bitboard stops = north_of(pawns) & compl attack_spans
+                   & bitboard::opponent_pawn_attacks(their_pawns);
+  bitboard backward = south_of(stops) & pawns;
+
+  score += doubled_penalty * doubled.popcnt();
+  score += isolated_penalty * isolated.popcnt();
+  score += backward_penalty * backward.popcnt();
+  for (auto index : passed) {
+    score += passed_bonus[rank_1.offset() - index.rank().offset()];
+  }
+  return score;
+}
+
+} /* anonym namespace */
+
+void evaluate_pawns(const ::kator::position& position, pawn_entry& entry)
+{
+  bitboard pawns = position.map_of(pawn);
+  bitboard their_pawns = position.map_of(opponent_pawn);
+
+  entry.key = position.get_pawn_zhash().get_value();
+  entry.score = side_terms(pawns, their_pawns, entry.passed);
+  entry.score -= side_terms(flip(their_pawns), flip(pawns),
+                            entry.opponent_passed);
+  entry.opponent_passed = flip(entry.opponent_passed);
+
+  entry.shields[pawn_entry::queenside] = shield_of(pawns, queenside_files);
+  entry.shields[pawn_entry::kingside] = shield_of(pawns, kingside_files);
+  entry.opponent_shields[pawn_entry::queenside] =
+    shield_of(flip(their_pawns), queenside_files);
+  entry.opponent_shields[pawn_entry::kingside] =
+    shield_of(flip(their_pawns), kingside_files);
+}
+
+pawn_table::pawn_table(unsigned log2_size):
+  entries(size_t(1) << log2_size),
+  mask((uint64_t(1) << log2_size) - 1)
+{
+  ASSUME(log2_size > 0);
+  clear();
+}
+
+/* The key of an empty slot never maps to the slot, thus {{{
+   no probe can match it.
+}}}*/
+void pawn_table::clear()
+{
+  for (size_t i = 0; i < entries.size(); ++i) {
+    entries[i].key = i ^ 1;
+  }
+  hits = 0;
+  misses = 0;
+}
+
+const pawn_entry& pawn_table::probe(const ::kator::position& position)
+{
+  uint64_t key = position.get_pawn_zhash().get_value();
+  pawn_entry& entry = entries[key & mask];
+
+  if (entry.key == key) {
+    ++hits;
+  }
+  else {
+    ++misses;
+    evaluate_pawns(position, entry);
+  }
+  return entry;
+}
+
+} /* namespace kator::engine */
+} /* namespace kator */
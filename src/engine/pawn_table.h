@@ -0,0 +1,80 @@
+
+#ifndef KATOR_ENGINE_PAWN_TABLE_H
+#define KATOR_ENGINE_PAWN_TABLE_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "chess/position.h"
+
+namespace kator
+{
+namespace engine
+{
+
+/* The evaluation of a pawn structure, depending only on the pawns. {{{
+   The score holds the passed, isolated, doubled, and backward pawn
+   terms, the player to move's terms minus the opponent's.
+   The shields are the midgame values of the pawns in front of a
+   castled king, one for the queenside ( files a, b, c ), and one for
+   the kingside ( files f, g, h ) -- picked by the file of the king
+   when evaluating a position.
+}}}*/
+struct pawn_entry
+{
+  uint64_t key;
+  psq_score score;
+  std::array<int16_t, 2> shields;
+  std::array<int16_t, 2> opponent_shields;
+  bitboard passed;
+  bitboard opponent_passed;
+
+  enum wing : unsigned { queenside, kingside };
+
+}; /* struct pawn_entry */
+
+void evaluate_pawns(const ::kator::position&, pawn_entry&);
+
+/* The cached pawn structure evaluations of a search thread. {{{
+   Pawn structures change rarely during a search, so most probes are
+   hits. Entries are replaced on each miss, and never shared between
+   threads, thus no synchronization is needed.
+   The constructor expects the base two logarithm of the entry count.
+   The counters of hits and misses are reset by clear().
+}}}*/
+class pawn_table
+{
+public:
+
+  static constexpr unsigned default_log2_size = 14;
+
+  explicit pawn_table(unsigned log2_size = default_log2_size);
+
+  const pawn_entry& probe(const ::kator::position&);
+
+  void clear();
+
+  unsigned long hit_count() const noexcept
+  {
+    return hits;
+  }
+
+  unsigned long miss_count() const noexcept
+  {
+    return misses;
+  }
+
+private:
+
+  std::vector<pawn_entry> entries;
+  uint64_t mask;
+  unsigned long hits;
+  unsigned long misses;
+
+}; /* class pawn_table */
+
+} /* namespace kator::engine */
+} /* namespace kator */
+
+#endif /* !defined(KATOR_ENGINE_PAWN_TABLE_H) */
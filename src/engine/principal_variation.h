@@ -0,0 +1,92 @@
+
+#ifndef KATOR_ENGINE_PRINCIPAL_VARIATION_H
+#define KATOR_ENGINE_PRINCIPAL_VARIATION_H
+
+#include <array>
+#include <cstdint>
+
+#include "chess/move.h"
+
+namespace kator
+{
+namespace engine
+{
+
+/* A line of moves found by the search, starting at the root. {{{
+   A fixed capacity array, small enough to be passed around in
+   search results by value -- a move_list would be almost four times
+   as large. Each move is relative to the position it is made in,
+   as the positions are flipped after every move.
+   Moves beyond max_length are silently dropped, no search is
+   expected to report a line that long.
+}}}*/
+class principal_variation
+{
+public:
+
+  static constexpr size_t max_length = 63;
+
+  principal_variation() noexcept:
+    length(0)
+  {
+  }
+
+  size_t size() const noexcept
+  {
+    return length;
+  }
+
+  bool empty() const noexcept
+  {
+    return length == 0;
+  }
+
+  move operator[] (size_t index) const noexcept
+  {
+    ASSUME(index < length);
+    return moves[index];
+  }
+
+  const move* begin() const noexcept
+  {
+    return moves.data();
+  }
+
+  const move* end() const noexcept
+  {
+    return moves.data() + length;
+  }
+
+  void clear() noexcept
+  {
+    length = 0;
+  }
+
+  void push_back(move move) noexcept
+  {
+    if (length < max_length) {
+      moves[length++] = move;
+    }
+  }
+
+  /* The line of a child node, preceded by the move leading to it */
+  void assign(move first, const principal_variation& child) noexcept
+  {
+    moves[0] = first;
+    length = 1;
+    for (auto move : child) {
+      push_back(move);
+    }
+  }
+
+private:
+
+  std::array<move, max_length> moves;
+  uint8_t length;
+
+}; /* class principal_variation */
+
+} /* namespace kator::engine */
+} /* namespace kator */
+
+#endif /* !defined(KATOR_ENGINE_PRINCIPAL_VARIATION_H) */
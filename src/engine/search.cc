@@ -7,7 +7,8 @@
 #include <thread>
 
 #include "engine.h"
-#include "node.h"
+#include "evaluator.h"
+#include "search_stack.h"
 #include "zhash_table.h"
 #include "chess/position.h"
 
@@ -19,20 +20,15 @@ namespace kator
 namespace engine
 {
 
-node::node(const ::kator::position& ctor_position):
-  position(ctor_position),
-  alpha(negative_infinite),
-  beta(positive_infinite),
-  killers({{null_move, null_move, null_move}})
-{
-}
-
 namespace 
 {
 
 class search_implementation : public search
 {
   const unique_ptr<const position> root;
+  search_stack stack;
+  history_table history;
+  evaluator eval;
   unsigned max_depth;
   unsigned long node_count;
   std::atomic<bool> is_running;
@@ -42,13 +38,14 @@ class search_implementation : public search
 
   void process_root_node()
   {
-    
+    stack.set_up_root(*root).generate_moves(history);
   }
 
 public:
 
   search_implementation(const position& ctor_root, unsigned ctor_depth):
     root(new position(ctor_root)),
+    stack(ctor_root),
     max_depth(ctor_depth),
     node_count(0),
     is_running(false)
@@ -92,9 +89,9 @@ public:
     return max_depth;
   }
 
-  move_list get_pv() const noexcept
+  principal_variation get_pv() const noexcept
   {
-    return move_list(*root);
+    return principal_variation();
   }
 
   position_value get_move_value(move) const
@@ -5,8 +5,8 @@
 #include <map>
 
 #include "chess/chess.h"
-#include "chess/move_list.h"
 #include "eval.h"
+#include "principal_variation.h"
 
 namespace kator
 {
@@ -27,7 +27,7 @@ public:
   virtual void reset() = 0;
   virtual void increase_depth() = 0;
   virtual unsigned current_depth() const noexcept = 0;
-  virtual move_list get_pv() const noexcept = 0;
+  virtual principal_variation get_pv() const noexcept = 0;
   virtual position_value get_move_value(move) const = 0;
   //virtual void set_transposition_table(zhash_table&) = 0;
 
@@ -0,0 +1,88 @@
+
+#include "search_stack.h"
+
+#include <new>
+#include <type_traits>
+
+namespace kator
+{
+namespace engine
+{
+
+static_assert(std::is_trivially_destructible<node>::value,
+              "the frames of a search_stack are never destroyed");
+
+node::node(const ::kator::position& ctor_position):
+  position(ctor_position),
+  moves(),
+  alpha(negative_infinite),
+  beta(positive_infinite),
+  static_value(position_value::null_value()),
+  killers({{packed_move::null(), packed_move::null(), packed_move::null()}})
+{
+  if (const nnue_network* network = nnue_network::active()) {
+    network->refresh(position, accumulator);
+  }
+}
+
+void node::set_up_root(const ::kator::position& root) noexcept
+{
+  position = root;
+  alpha = negative_infinite;
+  beta = positive_infinite;
+  static_value = position_value::null_value();
+  killers.fill(packed_move::null());
+  if (const nnue_network* network = nnue_network::active()) {
+    network->refresh(position, accumulator);
+  }
+}
+
+void node::set_up_child(const node& parent, move move) noexcept
+{
+  position.make_child(parent.position, move);
+  alpha = -parent.beta;
+  beta = -parent.alpha;
+  if (const nnue_network* network = nnue_network::active()) {
+    network->update(parent.position, parent.accumulator,
+                    position, accumulator);
+  }
+}
+
+void node::generate_moves(const history_table& history) noexcept
+{
+  moves.generate(position, history);
+}
+
+constexpr unsigned search_stack::max_ply;
+
+search_stack::search_stack(const position& root):
+  storage(new unsigned char[sizeof(node) * max_ply + alignof(node)])
+{
+  uintptr_t address = reinterpret_cast<uintptr_t>(storage.get());
+  size_t misalignment = address % alignof(node);
+  size_t offset = (misalignment == 0) ? 0 : (alignof(node) - misalignment);
+
+  frames = reinterpret_cast<node*>(storage.get() + offset);
+
+  // Touching all the memory now, rather than during the search
+  for (unsigned ply = 0; ply < max_ply; ++ply) {
+    new (frames + ply) node(root);
+  }
+}
+
+node& search_stack::set_up_root(const position& root) noexcept
+{
+  frames[0].set_up_root(root);
+  return frames[0];
+}
+
+node& search_stack::set_up_child(unsigned ply, move move) noexcept
+{
+  ASSUME(ply + 1 < max_ply);
+
+  frames[ply + 1].set_up_child(frames[ply], move);
+  return frames[ply + 1];
+}
+
+} /* namespace kator::engine */
+} /* namespace kator */
@@ -0,0 +1,58 @@
+
+#ifndef KATOR_ENGINE_SEARCH_STACK_H
+#define KATOR_ENGINE_SEARCH_STACK_H
+
+#include <memory>
+
+#include "node.h"
+
+namespace kator
+{
+namespace engine
+{
+
+/* The frames of one search thread, indexed by ply. {{{
+   All the frames are allocated, and constructed at once, when the
+   stack is created -- ahead of the search, which then only overwrites
+   them. One stack belongs to exactly one thread, nothing here is shared.
+   The memory is aligned to cache lines by hand, as the operator new
+   of C++14 does not respect the alignment of over-aligned types.
+}}}*/
+class search_stack
+{
+public:
+
+  static constexpr unsigned max_ply = 256;
+
+  explicit search_stack(const position& root);
+  search_stack(const search_stack&) = delete;
+  search_stack& operator= (const search_stack&) = delete;
+
+  node& operator[] (unsigned ply) noexcept
+  {
+    ASSUME(ply < max_ply);
+    return frames[ply];
+  }
+
+  const node& operator[] (unsigned ply) const noexcept
+  {
+    ASSUME(ply < max_ply);
+    return frames[ply];
+  }
+
+  node& set_up_root(const position&) noexcept;
+
+  /* Setting up the frame at ply + 1 */
+  node& set_up_child(unsigned ply, move) noexcept;
+
+private:
+
+  std::unique_ptr<unsigned char[]> storage;
+  node* frames;
+
+}; /* class search_stack */
+
+} /* namespace kator::engine */
+} /* namespace kator */
+
+#endif /* !defined(KATOR_ENGINE_SEARCH_STACK_H) */
@@ -23,6 +23,7 @@
 
 #include "config.h"
 #include "chess/zobrist_hash.h"
+#include "chess/move.h"
 #include "eval.h"
 
 
@@ -45,25 +46,24 @@ class hash_entry
   static constexpr unsigned value_type_bits = 2;
   static constexpr unsigned depth_bits = 7;
   static constexpr unsigned max_depth = (1 << depth_bits) - 1;
-  static constexpr unsigned move_index_bits = 8;
-  static constexpr unsigned max_move_index = (1 << move_index_bits) - 1;
+  static constexpr unsigned move_bits = packed_move::bits;
   static constexpr unsigned hash_upper_bits = 64
                                               - value_type_bits
                                               - depth_bits
-                                              - move_index_bits
+                                              - move_bits
                                               - position_value::bits;
 
   /*
   private: uint64_t value_adjusted    : position_value::bits;
   public:  uint64_t value_type        : value_type_bits;
   public:  uint64_t depth             : depth_bits;
-  public:  uint64_t move_index        : move_index_bits;
+  public:  uint64_t best_move         : move_bits;
   private: uint64_t hash_upper        : hash_upper_bits;
   */
 
   static constexpr unsigned value_type_start = position_value::bits;
   static constexpr unsigned depth_start = value_type_start + value_type_bits;
-  static constexpr unsigned move_index_start = depth_start + depth_bits;
+  static constexpr unsigned move_start = depth_start + depth_bits;
   static constexpr uint64_t hash_upper_mask =
     compl ((UINT64_C(1) << (64 - hash_upper_bits)) - UINT64_C(1));
 
@@ -134,14 +134,18 @@ public:
     internal |= value << value_type_start;
   }
 
-  constexpr unsigned move_index() const
+  /* The best move found, or a move causing a cutoff, {{{
+     packed so it can be validated with position::is_pseudo_legal,
+     and tried before generating any moves.
+  }}}*/
+  constexpr packed_move best_move() const
   {
-    return get_uint(move_index_start, move_index_bits);
+    return packed_move::from_uint(get_uint(move_start, move_bits));
   }
 
-  void set_move_index(unsigned value)
+  void set_best_move(packed_move move)
   {
-    internal |= value << move_index_start;
+    internal |= uint64_t(move.to_uint()) << move_start;
   }
 
   static constexpr hash_entry empty()
@@ -28,6 +28,7 @@
 #include "tests.h"
 #include "engine/eval.h"
 #include "engine/engine.h"
+#include "engine/nnue.h"
 #include "engine/search.h"
 
 #ifdef KATOR_ANDROID_NDK_PROFILING
@@ -99,9 +100,6 @@ static void startup()
   if (atexit(onexit) != 0) {
     exit(EXIT_FAILURE);
   }
-
-  ::kator::bitboard_lookup_tables_init();
-  ::kator::engine::position_value::default_initialize_lookup_tables();
 }
 
 static void onexit()
@@ -155,6 +153,24 @@ static void setup_nobook()
   conf.book_type = ::kator::book_type::empty;
 }
 
+static void setup_nnue(char**& arg)
+{
+  using kator::engine::nnue_network;
+
+  if (arg[1] == nullptr) {
+    usage(EXIT_FAILURE);
+  }
+  ++arg;
+  try {
+    nnue_network::set_active(nnue_network::load(string(*arg)));
+  }
+  catch (const std::exception& error) {
+    std::cerr << "Unable to load network " << *arg
+              << ": " << error.what() << "\n";
+    exit(EXIT_FAILURE);
+  }
+}
+
 static void print_version_banner()
 {
   std::cout << kator_version_string
@@ -210,6 +226,12 @@ static void print_version_verbose()
 #ifdef KATOR_USE_PEXT_BITBOARD
        << "KATOR_USE_PEXT_BITBOARD\n"
 #endif
+#ifdef KATOR_USE_KOGGE_STONE_ATTACKS
+       << "KATOR_USE_KOGGE_STONE_ATTACKS\n"
+#endif
+#ifdef KATOR_USE_RUNTIME_DISPATCH
+       << "KATOR_USE_RUNTIME_DISPATCH\n"
+#endif
 #ifdef KATOR_SYSTEM_POPCNT64
        << "KATOR_SYSTEM_POPCNT64\n"
 #endif
@@ -236,17 +258,19 @@ static void print_version_verbose()
 #endif
 #ifdef KATOR_HAS_BMI2_PEXT_BITBOARD_SUPPORT
        << "KATOR_HAS_BMI2_PEXT_BITBOARD_SUPPORT\n"
-#endif
-#ifdef KATOR_HAS_GCC_GLOBAL_REGISTER_VARIABLE_XMM
-       << "KATOR_HAS_GCC_GLOBAL_REGISTER_VARIABLE_XMM\n"
-#endif
-#ifdef KATOR_HAS_GCC_GLOBAL_REGISTER_VARIABLE_YMM
-       << "KATOR_HAS_GCC_GLOBAL_REGISTER_VARIABLE_YMM\n"
-#endif
-#ifdef KATOR_HAS_GCC_GLOBAL_REGISTER_VARIABLE_ZMM
-       << "KATOR_HAS_GCC_GLOBAL_REGISTER_VARIABLE_ZMM\n"
 #endif
        ;
+#ifdef KATOR_USE_RUNTIME_DISPATCH
+  const kator::cpu_features& cpu = kator::host_cpu_features();
+
+  std::cout << "Host CPU features:"
+            << (cpu.popcnt ? " popcnt" : "")
+            << (cpu.ssse3 ? " ssse3" : "")
+            << (cpu.avx2 ? " avx2" : "")
+            << (cpu.bmi2 ? " bmi2" : "")
+            << (cpu.avx512bw ? " avx512bw" : "")
+            << "\n";
+#endif
   exit(0);
 }
 
@@ -262,6 +286,7 @@ static void process_args(char **arg)
     else if (sarg == "--book")               setup_polyglot_book(arg);
     else if (sarg == "--fenbook")            setup_fen_book(arg);
     else if (sarg == "--nobook")             setup_nobook();
+    else if (sarg == "--nnue")               setup_nnue(arg);
     else if (sarg == "--unicode")            conf.use_unicode = true;
     else if (sarg == "--help")               usage(EXIT_SUCCESS);
     else if (sarg == "-help")                usage(EXIT_SUCCESS);
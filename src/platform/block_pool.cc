@@ -0,0 +1,292 @@
+
+#include "block_pool.h"
+
+#include <array>
+#include <atomic>
+
+namespace kator
+{
+
+namespace
+{
+
+constexpr size_t size_class_count = block_pool_max_size / cache_line_size;
+
+// Fresh memory is carved into blocks from chunks of this size
+constexpr size_t chunk_size = 64 * 1024;
+
+// A thread keeps at most this many free blocks of a size class
+constexpr size_t thread_free_limit = 256;
+
+// ...and hands over the surplus, down to this many
+constexpr size_t thread_free_low = thread_free_limit / 2;
+
+/* The first block of a batch, i.e.: a list of blocks handed over {{{
+   to a global list at once, also holds the tail and the length of
+   the batch, and the link to the next batch.
+}}}*/
+struct free_block
+{
+  free_block* next;
+  free_block* next_batch;
+  free_block* tail;
+  size_t count;
+};
+
+static_assert(sizeof(free_block) <= cache_line_size,
+              "the smallest block holds a batch header");
+
+/* The global lists are stacks of batches, each popped one at a time. {{{
+   The head pointer is stored with a tag in its top bits, counting
+   the updates, so a batch popped and pushed again by other threads
+   while a pop is in progress makes the compare-and-swap fail, instead
+   of resulting in the ABA problem. The next_batch field of the head
+   read by a pop might already belong to another thread's object by
+   then -- it is only read, and the pop is retried. The memory of the
+   blocks is never freed, thus this read is safe to do.
+}}}*/
+constexpr unsigned tag_shift = 48;
+constexpr uintptr_t pointer_mask = (uintptr_t(1) << tag_shift) - 1;
+
+std::array<std::atomic<uintptr_t>, size_class_count> global_free_lists;
+
+free_block* pointer_of(uintptr_t head) noexcept
+{
+  return reinterpret_cast<free_block*>(head & pointer_mask);
+}
+
+uintptr_t next_head(uintptr_t head, free_block* batch) noexcept
+{
+  uintptr_t address = reinterpret_cast<uintptr_t>(batch);
+
+  ASSUME((address & compl pointer_mask) == 0);
+  return (((head >> tag_shift) + 1) << tag_shift) | address;
+}
+
+size_t size_class_of(size_t size) noexcept
+{
+  return (size == 0) ? 0 : ((size - 1) / cache_line_size);
+}
+
+size_t block_size_of(size_t size_class) noexcept
+{
+  return (size_class + 1) * cache_line_size;
+}
+
+void push_global(size_t size_class, free_block* head, free_block* tail,
+                 size_t count) noexcept
+{
+  std::atomic<uintptr_t>& list = global_free_lists[size_class];
+  uintptr_t old_head = list.load(std::memory_order_relaxed);
+
+  tail->next = nullptr;
+  head->tail = tail;
+  head->count = count;
+  do {
+    head->next_batch = pointer_of(old_head);
+  } while (not list.compare_exchange_weak(old_head, next_head(old_head, head),
+                                          std::memory_order_release,
+                                          std::memory_order_relaxed));
+}
+
+free_block* pop_global(size_t size_class) noexcept
+{
+  std::atomic<uintptr_t>& list = global_free_lists[size_class];
+  uintptr_t old_head = list.load(std::memory_order_acquire);
+  free_block* batch;
+
+  do {
+    batch = pointer_of(old_head);
+    if (batch == nullptr) {
+      return nullptr;
+    }
+  } while (not list.compare_exchange_weak(old_head,
+                                          next_head(old_head,
+                                                    batch->next_batch),
+                                          std::memory_order_acquire,
+                                          std::memory_order_acquire));
+  return batch;
+}
+
+// Set when the thread's cache is destroyed, see block_pool_deallocate
+thread_local bool cache_destroyed = false;
+
+class thread_cache
+{
+public:
+
+  thread_cache() noexcept
+  {
+    for (auto& list : lists) {
+      list = {nullptr, nullptr, 0};
+    }
+  }
+
+  thread_cache(const thread_cache&) = delete;
+  thread_cache& operator= (const thread_cache&) = delete;
+
+  ~thread_cache()
+  {
+    for (size_t size_class = 0; size_class < size_class_count; ++size_class) {
+      free_list& list = lists[size_class];
+
+      if (list.head != nullptr) {
+        push_global(size_class, list.head, list.tail, list.count);
+      }
+    }
+    cache_destroyed = true;
+  }
+
+  void* allocate(size_t size_class)
+  {
+    free_list& list = lists[size_class];
+
+    if (list.head == nullptr) {
+      refill(size_class);
+      if (list.head == nullptr) {
+        return carve(size_class);
+      }
+    }
+
+    free_block* block = list.head;
+    list.head = block->next;
+    if (list.head == nullptr) {
+      list.tail = nullptr;
+    }
+    --list.count;
+    return block;
+  }
+
+  void deallocate(void* pointer, size_t size_class) noexcept
+  {
+    free_list& list = lists[size_class];
+    free_block* block = static_cast<free_block*>(pointer);
+
+    block->next = list.head;
+    if (list.head == nullptr) {
+      list.tail = block;
+    }
+    list.head = block;
+    if (++list.count > thread_free_limit) {
+      release_surplus(size_class);
+    }
+  }
+
+private:
+
+  struct free_list
+  {
+    free_block* head;
+    free_block* tail;
+    size_t count;
+  };
+
+  std::array<free_list, size_class_count> lists;
+
+  // The rest of the current chunk, not yet used for any block
+  unsigned char* chunk_next = nullptr;
+  unsigned char* chunk_end = nullptr;
+
+  /* The most recently freed blocks are kept, they are the most {{{
+     likely to be in the cache -- the rest, starting after the
+     first thread_free_low blocks, is handed over as one batch.
+  }}}*/
+  void release_surplus(size_t size_class) noexcept
+  {
+    free_list& list = lists[size_class];
+    free_block* last_kept = list.head;
+
+    for (size_t i = 1; i < thread_free_low; ++i) {
+      last_kept = last_kept->next;
+    }
+
+    push_global(size_class, last_kept->next, list.tail,
+                list.count - thread_free_low);
+    last_kept->next = nullptr;
+    list.tail = last_kept;
+    list.count = thread_free_low;
+  }
+
+  // Taking a single batch, at most thread_free_limit blocks
+  void refill(size_t size_class) noexcept
+  {
+    free_list& list = lists[size_class];
+    free_block* batch = pop_global(size_class);
+
+    if (batch != nullptr) {
+      list = {batch, batch->tail, batch->count};
+    }
+  }
+
+  void* carve(size_t size_class)
+  {
+    size_t block_size = block_size_of(size_class);
+
+    if (size_t(chunk_end - chunk_next) < block_size) {
+      new_chunk();
+    }
+
+    void* block = chunk_next;
+    chunk_next += block_size;
+    return block;
+  }
+
+  /* The remainder of the previous chunk is lost, it is smaller {{{
+     than block_pool_max_size. The chunks themselves are never
+     freed, there might be blocks in use from any of them,
+     in any thread.
+  }}}*/
+  void new_chunk()
+  {
+    unsigned char* storage = new unsigned char[chunk_size + cache_line_size];
+    uintptr_t address = reinterpret_cast<uintptr_t>(storage);
+    size_t misalignment = address % cache_line_size;
+    size_t offset = (misalignment == 0) ? 0 : (cache_line_size - misalignment);
+
+    chunk_next = storage + offset;
+    chunk_end = chunk_next + chunk_size;
+  }
+
+}; /* class thread_cache */
+
+thread_local thread_cache cache;
+
+} /* anonym namespace */
+
+void* block_pool_allocate(size_t size)
+{
+  if (size > block_pool_max_size) {
+    return aligned_allocate(size, cache_line_size);
+  }
+
+  /* Memory for a block, that is freed to the global list later, {{{
+     just like the ones carved from the chunks of a thread.
+  }}}*/
+  if (cache_destroyed) {
+    return aligned_allocate(block_size_of(size_class_of(size)),
+                            cache_line_size);
+  }
+
+  return cache.allocate(size_class_of(size));
+}
+
+void block_pool_deallocate(void* pointer, size_t size) noexcept
+{
+  if (pointer == nullptr) {
+    return;
+  }
+
+  if (size > block_pool_max_size) {
+    anligned_deallocate(pointer);
+  }
+  else if (cache_destroyed) {
+    free_block* block = static_cast<free_block*>(pointer);
+
+    push_global(size_class_of(size), block, block, 1);
+  }
+  else {
+    cache.deallocate(pointer, size_class_of(size));
+  }
+}
+
+} /* namespace kator */
@@ -0,0 +1,33 @@
+
+#ifndef KATOR_PLATFORM_BLOCK_POOL_H
+#define KATOR_PLATFORM_BLOCK_POOL_H
+
+#include "platform.h"
+
+namespace kator
+{
+
+/* A pool of cache line aligned memory blocks, for objects allocated {{{
+   and freed in great numbers, e.g.: a position for every move made
+   in a game_state.
+   The requested sizes are rounded up to a multiple of cache_line_size,
+   and each such size class has its own free list in every thread, so
+   allocating and freeing touches no shared state most of the time.
+   A thread that ends up with too many free blocks hands over the
+   surplus -- or everything, when it exits -- as a batch to a global
+   list of the size class. A thread with no free blocks left takes a
+   single batch from there. The global lists are updated with
+   compare-and-swap, thus no locks are taken anywhere. The memory is
+   never returned to the system, a block freed in one thread can be
+   reused by any other.
+   Requests larger than block_pool_max_size go to aligned_allocate.
+}}}*/
+
+constexpr size_t block_pool_max_size = 64 * cache_line_size;
+
+void* block_pool_allocate(size_t size);
+void block_pool_deallocate(void* pointer, size_t size) noexcept;
+
+} /* namespace kator */
+
+#endif /* !defined(KATOR_PLATFORM_BLOCK_POOL_H) */
@@ -1,86 +1,29 @@
 
 #include "platform.h"
-#include "x64_vectors.h"
 
 #include <new>
 
-#if defined(KATOR_HAS_X64_512BIT_BUILTINS)
-
-static const __m512i bswap_shuffle_key_64_value = {
-                  15, 14, 13, 12, 11, 10,  9,  8,
-                   7,  6,  5,  4,  3,  2,  1,  0,
-                  15, 14, 13, 12, 11, 10,  9,  8,
-                   7,  6,  5,  4,  3,  2,  1,  0,
-                  15, 14, 13, 12, 11, 10,  9,  8,
-                   7,  6,  5,  4,  3,  2,  1,  0,
-                  15, 14, 13, 12, 11, 10,  9,  8,
-                   7,  6,  5,  4,  3,  2,  1,  0};
-
-#  ifndef  KATOR_HAS_GCC_GLOBAL_REGISTER_VARIABLE_ZMM
-
-     const __m512i kator::bswap_shuffle_key_64 = bswap_shuffle_key_64_value;
-
-#  endif
-
-#elif defined(KATOR_HAS_X64_256BIT_AVX2_BUILTINS)
-
-static const __m256i bswap_shuffle_key_32_value = _mm256_setr_epi8(
-                  15, 14, 13, 12, 11, 10,  9,  8,
-                   7,  6,  5,  4,  3,  2,  1,  0,
-                  15, 14, 13, 12, 11, 10,  9,  8,
-                   7,  6,  5,  4,  3,  2,  1,  0);
-
-#  ifndef KATOR_HAS_GCC_GLOBAL_REGISTER_VARIABLE_YMM
-
-     const __m256i kator::bswap_shuffle_key_32 = bswap_shuffle_key_32_value;
-
-#  endif
-
-#elif defined(KATOR_HAS_X64_128BIT_SSSE3_SHUFFLE_BUILTIN)
-
-static const __m128i bswap_shuffle_key_16_value = _mm_setr_epi8(
-                  15, 14, 13, 12, 11, 10,  9,  8,
-                   7,  6,  5,  4,  3,  2,  1,  0);
-
-#  ifndef KATOR_HAS_GCC_GLOBAL_REGISTER_VARIABLE_XMM
-
-     const __m128i kator::bswap_shuffle_key_16 = bswap_shuffle_key_16_value;
-
-#  endif
-
-#endif
-
-void kator::initialize_permanent_vectors()
+static kator::cpu_features detect_cpu_features()
 {
-# if defined(KATOR_HAS_GCC_GLOBAL_REGISTER_VARIABLE_XMM) \
-     && defined(KATOR_HAS_X64_128BIT_BUILTINS)
-
-#   if defined(KATOR_HAS_GCC_GLOBAL_REGISTER_VARIABLE_YMM) \
-       && defined(KATOR_HAS_X64_256BIT_BUILTINS)
-
-#     if defined(KATOR_HAS_GCC_GLOBAL_REGISTER_VARIABLE_ZMM) \
-       && defined(KATOR_HAS_X64_512BIT_BUILTINS)
-
-        
-        vector_64_one = _mm512_set1_epi8(1);
-        bswap_shuffle_key_64 = bswap_shuffle_key_64_value;
-   
-#     else
-
-        vector_32_one = _mm256_set1_epi8(1);
-        bswap_shuffle_key_32 = bswap_shuffle_key_32_value;
-
-#     endif
-#   else
+  kator::cpu_features features = {};
+
+#ifdef KATOR_HAS_GCC_TARGET_ATTRIBUTE
+  __builtin_cpu_init();
+  features.popcnt = __builtin_cpu_supports("popcnt");
+  features.ssse3 = __builtin_cpu_supports("ssse3");
+  features.avx2 = __builtin_cpu_supports("avx2");
+  features.bmi2 = __builtin_cpu_supports("bmi2");
+  features.avx512bw = __builtin_cpu_supports("avx512bw");
+#endif
 
-    vector_16_one = _mm_set1_epi8(1);
+  return features;
+}
 
-#   ifdef KATOR_HAS_X64_128BIT_SSSE3_SHUFFLE_BUILTIN
-    bswap_shuffle_key_16 = bswap_shuffle_key_16_value;
-#   endif
+const kator::cpu_features& kator::host_cpu_features()
+{
+  static const cpu_features features = detect_cpu_features();
 
-#   endif
-# endif
+  return features;
 }
 
 #if defined(KATOR_USE_ALIGNAS_64) || defined(KATOR_USE_ALIGNAS_32)
@@ -84,6 +84,20 @@
 #  define COMPILER_EXPECT(x, y) (x)
 #endif
 
+/* Hot entry points compiled once per CPU generation, {{{
+   when building a portable binary. The dynamic linker picks
+   the clone matching the host CPU at startup, and within each
+   clone popcount, ctz, blsr, bswap are inlined as single
+   instructions -- everything the entry point calls inline
+   is compiled for the same target.
+}}}*/
+#if defined(KATOR_USE_RUNTIME_DISPATCH) && defined(KATOR_HAS_GCC_TARGET_CLONES)
+#  define KATOR_MULTIVERSION \
+     __attribute__ ((flatten, target_clones("default", "popcnt", "arch=haswell")))
+#else
+#  define KATOR_MULTIVERSION
+#endif
+
 
 
 
@@ -219,6 +233,11 @@ static inline void platform_prefetch_for_write_3(const void*) { }
 namespace kator
 {
 
+/* The size of a cache line on most CPUs of interest, used for {{{
+   keeping data of different threads on separate cache lines.
+}}}*/
+constexpr size_t cache_line_size = 64;
+
 void* aligned_allocate(size_t size, size_t alignment);
 void anligned_deallocate(void*);
 
@@ -281,7 +300,22 @@ using ::std::allocator aligned_allocator;
 #endif // !defined(KATOR_USE_ALIGNAS_64)
 
 
-void initialize_permanent_vectors();
+/* The instruction set extensions available on the host, {{{
+   detected once, at the first call. Used for selecting among
+   the implementations of a routine, in a build using
+   KATOR_USE_RUNTIME_DISPATCH. Without compiler support for
+   the detection, all of these are false.
+}}}*/
+struct cpu_features
+{
+  bool popcnt;
+  bool ssse3;
+  bool avx2;
+  bool bmi2;
+  bool avx512bw;
+};
+
+const cpu_features& host_cpu_features();
 
 } /* namespace kator */
 
@@ -0,0 +1,147 @@
+
+#ifndef KATOR_PLATFORM_VECTORS_H
+#define KATOR_PLATFORM_VECTORS_H
+
+#include "platform.h"
+
+/* A small portable vector of four 64 bit lanes. {{{
+   With compilers supporting GCC style vector extensions ( GCC, clang )
+   this is a vector type, and the compiler picks the instructions
+   for the target -- e.g. AVX2 variable shifts, or pairs of SSE2 or NEON
+   operations. Otherwise it is a plain struct, with the same operations
+   done lane by lane.
+   Constants are just vectors initialized the usual way, the compiler
+   is free to keep them in registers, or load them from memory, as it
+   sees fit.
+   Shifting a lane by 64 or more is undefined, the same as with scalars.
+}}}*/
+
+namespace kator
+{
+
+#ifdef KATOR_HAS_GCC_VECTOR
+
+typedef uint64_t u64x4 __attribute__ ((vector_size(32)));
+
+static inline u64x4
+make_u64x4(uint64_t lane0, uint64_t lane1, uint64_t lane2, uint64_t lane3)
+{
+  return u64x4{lane0, lane1, lane2, lane3};
+}
+
+static inline uint64_t lane_of(u64x4 vector, unsigned index)
+{
+  return vector[index];
+}
+
+#else // defined(KATOR_HAS_GCC_VECTOR)
+
+struct u64x4
+{
+  uint64_t lane[4];
+
+  template<typename operation>
+  static u64x4 lanewise(u64x4 a, u64x4 b, operation op)
+  {
+    return u64x4{{ op(a.lane[0], b.lane[0]), op(a.lane[1], b.lane[1]),
+                   op(a.lane[2], b.lane[2]), op(a.lane[3], b.lane[3]) }};
+  }
+
+  u64x4 operator & (u64x4 other) const
+  {
+    return lanewise(*this, other, [](uint64_t a, uint64_t b) { return a & b; });
+  }
+
+  u64x4 operator | (u64x4 other) const
+  {
+    return lanewise(*this, other, [](uint64_t a, uint64_t b) { return a | b; });
+  }
+
+  u64x4 operator + (u64x4 other) const
+  {
+    return lanewise(*this, other, [](uint64_t a, uint64_t b) { return a + b; });
+  }
+
+  u64x4 operator - (u64x4 other) const
+  {
+    return lanewise(*this, other, [](uint64_t a, uint64_t b) { return a - b; });
+  }
+
+  u64x4 operator << (u64x4 counts) const
+  {
+    return lanewise(*this, counts,
+                    [](uint64_t a, uint64_t b) { return a << b; });
+  }
+
+  u64x4 operator >> (u64x4 counts) const
+  {
+    return lanewise(*this, counts,
+                    [](uint64_t a, uint64_t b) { return a >> b; });
+  }
+
+  u64x4 operator compl () const
+  {
+    return u64x4{{ compl lane[0], compl lane[1],
+                   compl lane[2], compl lane[3] }};
+  }
+
+  u64x4& operator &= (u64x4 other)
+  {
+    return *this = *this & other;
+  }
+
+  u64x4& operator |= (u64x4 other)
+  {
+    return *this = *this | other;
+  }
+
+}; /* struct u64x4 */
+
+static inline u64x4
+make_u64x4(uint64_t lane0, uint64_t lane1, uint64_t lane2, uint64_t lane3)
+{
+  return u64x4{{lane0, lane1, lane2, lane3}};
+}
+
+static inline uint64_t lane_of(u64x4 vector, unsigned index)
+{
+  return vector.lane[index];
+}
+
+#endif // !defined(KATOR_HAS_GCC_VECTOR)
+
+static inline u64x4 broadcast_u64x4(uint64_t value)
+{
+  return make_u64x4(value, value, value, value);
+}
+
+static inline uint64_t or_of_lanes(u64x4 vector)
+{
+  return lane_of(vector, 0) | lane_of(vector, 1)
+         | lane_of(vector, 2) | lane_of(vector, 3);
+}
+
+/* The population count of each lane. {{{
+   Summing bits in ever wider fields: pairs, nibbles, bytes -- then
+   the bytes are added into the lowest one. Only shifts, masks,
+   and additions, thus each step is one instruction on all four
+   lanes, where the target has 256 bit vectors.
+}}}*/
+static inline u64x4 popcnt_lanes(u64x4 vector)
+{
+  const u64x4 pairs = broadcast_u64x4(UINT64_C(0x5555555555555555));
+  const u64x4 nibbles = broadcast_u64x4(UINT64_C(0x3333333333333333));
+  const u64x4 bytes = broadcast_u64x4(UINT64_C(0x0f0f0f0f0f0f0f0f));
+
+  vector = vector - ((vector >> broadcast_u64x4(1)) & pairs);
+  vector = (vector & nibbles) + ((vector >> broadcast_u64x4(2)) & nibbles);
+  vector = (vector + (vector >> broadcast_u64x4(4))) & bytes;
+  vector = vector + (vector >> broadcast_u64x4(8));
+  vector = vector + (vector >> broadcast_u64x4(16));
+  vector = vector + (vector >> broadcast_u64x4(32));
+  return vector & broadcast_u64x4(0x7f);
+}
+
+} /* namespace kator */
+
+#endif /* !defined(KATOR_PLATFORM_VECTORS_H) */
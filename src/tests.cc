@@ -24,15 +24,17 @@ unsigned long compute_perft(const ::kator::position& position, unsigned depth)
     return 1;
   }
 
-  move_list moves(position);
   if (type == perft_type::simple and depth == 1) {
-    return static_cast<unsigned long>(moves.count());
+    return static_cast<unsigned long>(count_legal_moves(position));
   }
 
+  move moves[move_list::max_size];
+  size_t count = generate_legal_moves(position, moves);
+
   unsigned long n = 0;
 
-  for (auto move : moves) {
-    class position child(position, move);
+  for (size_t i = 0; i < count; ++i) {
+    class position child(position, moves[i]);
 
     n += compute_perft<type>(child, depth - 1);
   }
@@ -44,14 +46,12 @@ unsigned long compute_perft(const ::kator::position& position, unsigned depth)
 unsigned long
 perft(const position& position, unsigned depth)
 {
-  initialize_permanent_vectors();
   return compute_perft<simple>(position, depth);
 }
 
 unsigned long
 slow_perft(const position& position, unsigned depth)
 {
-  initialize_permanent_vectors();
   return compute_perft<with_make_move>(position, depth);
 }
 
@@ -0,0 +1,76 @@
+
+#include "gtest.h"
+#include "chess/game_state.h"
+#include "engine/activity.h"
+#include "platform/vectors.h"
+
+using namespace ::kator;
+using ::kator::engine::activity_counts;
+using ::kator::engine::count_activity;
+
+TEST(engine_activity, popcnt_lanes)
+{
+  const uint64_t lanes[] = {
+    0, ~UINT64_C(0), UINT64_C(0x8000000000000001), UINT64_C(0x123456789abcdef)
+  };
+  u64x4 counts = popcnt_lanes(make_u64x4(lanes[0], lanes[1],
+                                         lanes[2], lanes[3]));
+
+  for (unsigned i = 0; i < 4; ++i) {
+    ASSERT_EQ(unsigned(bitboard(lanes[i]).popcnt()), lane_of(counts, i));
+  }
+}
+
+TEST(engine_activity, count_activity)
+{
+  auto state = parse_fen(
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+  const position& position = *state->position;
+  activity_counts counts = count_activity(position);
+
+  bitboard area = compl (position.map_of(player_to_move)
+                         | position.attacks_of(opponent_pawn));
+  bitboard zone = bitboard::king_attacks(position.opponent_king_index())
+                  | bitboard(position.opponent_king_index());
+
+  for (unsigned i = 0; i < activity_counts::pieces.size(); ++i) {
+    bitboard attacks = position.attacks_of(
+        make_square(activity_counts::pieces[i], player_to_move));
+
+    ASSERT_EQ(unsigned((attacks & area).popcnt()), counts.mobility[i]);
+    ASSERT_EQ(unsigned((attacks & zone).popcnt()),
+              counts.king_zone_attacks[i]);
+  }
+
+  // The knights on c3 and e5, c6 and g6 are defended by pawns
+  ASSERT_EQ(9u, counts.mobility[2]);
+}
+
+TEST(engine_activity, batch)
+{
+  const char* const fens[activity_counts::batch_size] = {
+    starting_fen,
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"
+  };
+  std::unique_ptr<game_state> states[activity_counts::batch_size];
+  const position* positions[activity_counts::batch_size];
+  activity_counts counts[activity_counts::batch_size];
+
+  for (unsigned i = 0; i < activity_counts::batch_size; ++i) {
+    states[i] = parse_fen(fens[i]);
+    positions[i] = states[i]->position.get();
+  }
+  count_activity(positions, counts);
+
+  for (unsigned i = 0; i < activity_counts::batch_size; ++i) {
+    activity_counts single = count_activity(*positions[i]);
+
+    ASSERT_EQ(single.mobility, counts[i].mobility);
+    ASSERT_EQ(single.opponent_mobility, counts[i].opponent_mobility);
+    ASSERT_EQ(single.king_zone_attacks, counts[i].king_zone_attacks);
+    ASSERT_EQ(single.opponent_king_zone_attacks,
+              counts[i].opponent_king_zone_attacks);
+  }
+}
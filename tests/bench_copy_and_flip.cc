@@ -0,0 +1,90 @@
+
+/* Microbenchmark of the copy-and-flip implementations. {{{
+   Each implementation available in the build, and supported by the
+   CPU is timed copying a position's board and piece maps into
+   another buffer, the way make_move does it. The parent positions
+   are not written just before being copied, as in a search, thus
+   there is no dependency between the iterations. The calls go through
+   the same function pointers the runtime dispatch uses.
+   The numbers are only meaningful relative to each other, on the
+   same machine. Not run as part of ctest.
+}}}*/
+
+#include "chess/copy_and_flip.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+using namespace ::kator;
+
+namespace
+{
+
+constexpr size_t buffer_count = 64;
+
+struct position_data
+{
+  unsigned char board[64];
+  uint64_t piece_maps[flipped_piece_map_count];
+};
+
+position_data parents[buffer_count];
+position_data children[buffer_count];
+
+double measure(const copy_and_flip_implementation& impl, unsigned long count)
+{
+  auto start = std::chrono::steady_clock::now();
+
+  for (unsigned long i = 0; i < count; ++i) {
+    const position_data& src = parents[i % buffer_count];
+    position_data& dst = children[(i * 7) % buffer_count];
+
+    impl.board(dst.board, src.board);
+    impl.piece_maps(dst.piece_maps, src.piece_maps);
+  }
+
+  std::chrono::duration<double, std::nano> elapsed =
+    std::chrono::steady_clock::now() - start;
+
+  return elapsed.count() / count;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+  unsigned long count = 50000000;
+
+  if (argc > 1) {
+    count = std::strtoul(argv[1], nullptr, 10);
+  }
+
+  for (auto& parent : parents) {
+    for (size_t i = 0; i < 64; ++i) {
+      parent.board[i] = static_cast<unsigned char>(i % 7);
+    }
+    for (size_t i = 0; i < flipped_piece_map_count; ++i) {
+      parent.piece_maps[i] = UINT64_C(0x8040201008040201) << i;
+    }
+  }
+
+  for (size_t i = 0; i < copy_and_flip_implementation_count; ++i) {
+    const copy_and_flip_implementation& impl =
+      copy_and_flip_implementations[i];
+
+    std::cout << std::setw(10) << impl.name << ": ";
+    if (impl.is_supported()) {
+      measure(impl, count / 10);
+      std::cout << std::fixed << std::setprecision(2)
+                << measure(impl, count) << " ns\n";
+    }
+    else {
+      std::cout << "not supported by this CPU\n";
+    }
+  }
+  std::cout << "best: " << best_copy_and_flip().name << "\n";
+
+  return EXIT_SUCCESS;
+}
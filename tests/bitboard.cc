@@ -0,0 +1,61 @@
+
+#include "gtest.h"
+#include "chess/kogge_stone.h"
+
+#include <random>
+
+using namespace ::kator;
+
+namespace
+{
+
+bitboard union_of_bishop_attacks(bitboard bishops, bitboard occupied)
+{
+  bitboard result = bitboard::empty();
+
+  for (auto index : bishops) {
+    result.merge(bitboard::bishop_attacks(occupied, index));
+  }
+  return result;
+}
+
+bitboard union_of_rook_attacks(bitboard rooks, bitboard occupied)
+{
+  bitboard result = bitboard::empty();
+
+  for (auto index : rooks) {
+    result.merge(bitboard::rook_attacks(occupied, index));
+  }
+  return result;
+}
+
+template<typename bishop_function, typename rook_function>
+void check_fill_attacks(bishop_function bishop_fill, rook_function rook_fill)
+{
+  std::mt19937_64 random(4321);
+
+  for (int i = 0; i < 10000; ++i) {
+    // sparse occupancies are more interesting, with long rays
+    bitboard occupied(random() & random() & random());
+    bitboard sliders(occupied.to_uint64_t() & random());
+
+    ASSERT_EQ(union_of_bishop_attacks(sliders, occupied),
+              bishop_fill(sliders, occupied));
+    ASSERT_EQ(union_of_rook_attacks(sliders, occupied),
+              rook_fill(sliders, occupied));
+  }
+}
+
+}
+
+TEST(chess_bitboard, scalar_fill_attacks)
+{
+  check_fill_attacks(kogge_stone::scalar_bishop_fill_attacks,
+                     kogge_stone::scalar_rook_fill_attacks);
+}
+
+TEST(chess_bitboard, vector_fill_attacks)
+{
+  check_fill_attacks(kogge_stone::vector_bishop_fill_attacks,
+                     kogge_stone::vector_rook_fill_attacks);
+}
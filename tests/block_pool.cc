@@ -0,0 +1,139 @@
+
+#include "gtest.h"
+#include "platform/block_pool.h"
+
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <thread>
+#include <vector>
+
+using ::kator::block_pool_allocate;
+using ::kator::block_pool_deallocate;
+using ::kator::block_pool_max_size;
+using ::kator::cache_line_size;
+
+namespace
+{
+
+const size_t sizes[] = {1, cache_line_size, 352, 900, block_pool_max_size};
+
+std::vector<void*> allocate_all(size_t size, unsigned count)
+{
+  std::vector<void*> blocks;
+
+  for (unsigned i = 0; i < count; ++i) {
+    void* block = block_pool_allocate(size);
+    std::memset(block, 0xa5, size);
+    blocks.push_back(block);
+  }
+  return blocks;
+}
+
+void deallocate_all(const std::vector<void*>& blocks, size_t size)
+{
+  for (auto block : blocks) {
+    block_pool_deallocate(block, size);
+  }
+}
+
+}
+
+TEST(platform_block_pool, blocks)
+{
+  for (auto size : sizes) {
+    auto blocks = allocate_all(size, 1000);
+    std::set<void*> distinct(blocks.begin(), blocks.end());
+
+    ASSERT_EQ(blocks.size(), distinct.size());
+    for (auto block : blocks) {
+      ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(block) % cache_line_size);
+    }
+    deallocate_all(blocks, size);
+
+    // The most recently freed block is the first one reused
+    void* block = block_pool_allocate(size);
+    ASSERT_EQ(blocks.back(), block);
+    block_pool_deallocate(block, size);
+  }
+}
+
+TEST(platform_block_pool, other_threads)
+{
+  std::vector<void*> blocks;
+
+  // Allocated in one thread, freed in another, reused in a third one
+  std::thread([&]{ blocks = allocate_all(352, 1000); }).join();
+  std::thread([&]{ deallocate_all(blocks, 352); }).join();
+  std::thread([&]{
+    std::vector<void*> reused = allocate_all(352, 1000);
+    std::set<void*> all(blocks.begin(), blocks.end());
+
+    all.insert(reused.begin(), reused.end());
+    ASSERT_EQ(blocks.size(), all.size());
+    deallocate_all(reused, 352);
+  }).join();
+
+  block_pool_deallocate(block_pool_allocate(block_pool_max_size + 1),
+                        block_pool_max_size + 1);
+}
+
+namespace
+{
+
+void* freed_at_thread_exit;
+
+// Constructed before the pool's own thread_local cache, destroyed after it
+struct late_owner
+{
+  void* block = nullptr;
+
+  ~late_owner()
+  {
+    block_pool_deallocate(block, 352);
+    freed_at_thread_exit = block;
+  }
+};
+
+}
+
+TEST(platform_block_pool, after_thread_exit)
+{
+  std::thread([]{
+    static thread_local late_owner owner;
+
+    owner.block = block_pool_allocate(352);
+  }).join();
+
+  ASSERT_NE(nullptr, freed_at_thread_exit);
+
+  std::thread([]{
+    std::vector<void*> blocks = allocate_all(352, 2000);
+    std::set<void*> all(blocks.begin(), blocks.end());
+
+    ASSERT_EQ(1u, all.count(freed_at_thread_exit));
+    deallocate_all(blocks, 352);
+  }).join();
+}
+
+TEST(platform_block_pool, surplus)
+{
+  // Freeing many blocks at once, then allocating and freeing a single one
+  auto blocks = allocate_all(900, 5000);
+
+  deallocate_all(blocks, 900);
+  for (int i = 0; i < 10000; ++i) {
+    void* block = block_pool_allocate(900);
+
+    ASSERT_EQ(blocks.back(), block);
+    block_pool_deallocate(block, 900);
+  }
+
+  // Every block is reused, from the batches handed over
+  auto reused = allocate_all(900, 5000);
+  std::set<void*> all(blocks.begin(), blocks.end());
+
+  all.insert(reused.begin(), reused.end());
+  ASSERT_EQ(blocks.size(), all.size());
+  deallocate_all(reused, 900);
+}
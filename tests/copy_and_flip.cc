@@ -0,0 +1,89 @@
+
+#include "gtest.h"
+#include "chess/copy_and_flip.h"
+
+#include <random>
+
+using namespace ::kator;
+
+namespace
+{
+
+template<typename T, size_t size>
+void randomize(T (&array)[size], std::mt19937_64& random)
+{
+  for (auto& item : array) {
+    item = static_cast<T>(random());
+  }
+}
+
+}
+
+TEST(chess_copy_and_flip, portable)
+{
+  unsigned char board[64];
+  unsigned char flipped[64];
+  uint64_t maps[flipped_piece_map_count];
+  uint64_t flipped_maps[flipped_piece_map_count];
+
+  for (unsigned i = 0; i < 64; ++i) {
+    board[i] = static_cast<unsigned char>(i);
+  }
+  portable_board_copy_and_flip(flipped, board);
+  for (unsigned i = 0; i < 64; ++i) {
+    ASSERT_EQ((7 - i / 8) * 8 + i % 8, flipped[i]);
+  }
+
+  for (size_t i = 0; i < flipped_piece_map_count; ++i) {
+    maps[i] = UINT64_C(0x0102030405060708) * (i + 1);
+  }
+  portable_piece_map_copy_and_flip(flipped_maps, maps);
+  for (size_t i = 0; i < flipped_piece_map_count; ++i) {
+    ASSERT_EQ(flip(bitboard(maps[i ^ 1])).to_uint64_t(), flipped_maps[i]);
+  }
+}
+
+TEST(chess_copy_and_flip, implementations)
+{
+  std::mt19937_64 random(1234);
+
+  for (size_t i = 0; i < copy_and_flip_implementation_count; ++i) {
+    const copy_and_flip_implementation& impl =
+      copy_and_flip_implementations[i];
+
+    if (not impl.is_supported()) {
+      continue;
+    }
+
+    for (int round = 0; round < 100; ++round) {
+      unsigned char board_storage[64 + 1];
+      uint64_t maps[flipped_piece_map_count];
+      unsigned char expected[64];
+      unsigned char result[64 + 1];
+      uint64_t expected_maps[flipped_piece_map_count];
+      uint64_t result_maps[flipped_piece_map_count + 1];
+
+      randomize(board_storage, random);
+      randomize(maps, random);
+
+      // Unaligned addresses are supposed to work as well
+      const unsigned char* board = board_storage + (round % 2);
+      unsigned char* board_result = result + (round % 2);
+      uint64_t* maps_result = result_maps + (round % 2);
+
+      portable_board_copy_and_flip(expected, board);
+      impl.board(board_result, board);
+      ASSERT_EQ(0, std::memcmp(expected, board_result, 64)) << impl.name;
+
+      portable_piece_map_copy_and_flip(expected_maps, maps);
+      impl.piece_maps(maps_result, maps);
+      ASSERT_EQ(0, std::memcmp(expected_maps, maps_result, sizeof(maps)))
+        << impl.name;
+    }
+  }
+}
+
+TEST(chess_copy_and_flip, best)
+{
+  ASSERT_TRUE(best_copy_and_flip().is_supported());
+}
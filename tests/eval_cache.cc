@@ -0,0 +1,44 @@
+
+#include "gtest.h"
+#include "chess/game_state.h"
+#include "engine/eval_cache.h"
+#include "engine/evaluator.h"
+
+using namespace ::kator;
+using ::kator::engine::eval_cache;
+using ::kator::engine::evaluator;
+using ::kator::engine::position_value;
+
+TEST(engine_eval_cache, probe)
+{
+  eval_cache cache(4);
+  zobrist_hash key(UINT64_C(0x123456789abcdef3));
+  zobrist_hash other(UINT64_C(0x223456789abcdef3));
+  position_value value = position_value::null_value();
+
+  ASSERT_FALSE(cache.probe(key, value));
+  cache.store(key, position_value::create_from_int(-37));
+  ASSERT_TRUE(cache.probe(key, value));
+  ASSERT_EQ(-37, value.as_int());
+
+  // Same slot, different key
+  ASSERT_FALSE(cache.probe(other, value));
+  ASSERT_EQ(1u, cache.hit_count());
+  ASSERT_EQ(2u, cache.miss_count());
+
+  cache.clear();
+  ASSERT_FALSE(cache.probe(key, value));
+}
+
+TEST(engine_eval_cache, evaluator)
+{
+  auto state = parse_fen(
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+  evaluator eval;
+
+  position_value first = eval.evaluate(*state->position);
+  position_value second = eval.evaluate(*state->position);
+  ASSERT_EQ(first.as_int(), second.as_int());
+  ASSERT_EQ(1u, eval.cache_hit_count());
+  ASSERT_EQ(1u, eval.cache_miss_count());
+}
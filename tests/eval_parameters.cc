@@ -0,0 +1,93 @@
+
+#include "gtest.h"
+#include "chess/game_state.h"
+#include "engine/evaluator.h"
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+using ::kator::piece;
+using ::kator::engine::position_value;
+
+// Loads the defaults after each test, even a failing one
+class engine_eval_parameters : public ::testing::Test
+{
+protected:
+
+  void TearDown() override
+  {
+    std::istringstream empty("");
+    position_value::initialize_lookup_tables(empty);
+  }
+
+};
+
+TEST_F(engine_eval_parameters, binary)
+{
+  std::istringstream text("# comment\nrook = 0x48\nlazy_margin_endgame = 40\n");
+  std::ostringstream binary;
+
+  position_value::convert_parameters(text, binary);
+  std::string data = binary.str();
+
+  position_value::initialize_lookup_tables(data.data(), data.size());
+  ASSERT_EQ(0x48, position_value(piece::rook).as_int());
+  ASSERT_EQ(0x30, position_value(piece::bishop).as_int());
+  ASSERT_EQ(40, position_value::get_lazy_margin().endgame());
+
+  ASSERT_THROW(position_value::initialize_lookup_tables(data.data(),
+                                                        data.size() - 1),
+               std::invalid_argument);
+  data[0] = 'k';
+  ASSERT_THROW(position_value::initialize_lookup_tables(data.data(),
+                                                        data.size()),
+               std::invalid_argument);
+}
+
+TEST_F(engine_eval_parameters, invalid_text)
+{
+  const char* const invalid[] = {
+    "rook = abc\n",
+    "rook = 0x10000\n",
+    "rook = 70000\n",
+    "rook 0x50\n"
+  };
+
+  for (auto text : invalid) {
+    std::istringstream conversion_input(text);
+    std::ostringstream binary;
+    std::istringstream input(text);
+
+    ASSERT_THROW(position_value::convert_parameters(conversion_input, binary),
+                 std::invalid_argument);
+    ASSERT_THROW(position_value::initialize_lookup_tables(input),
+                 std::invalid_argument);
+  }
+
+  // Nothing is changed by a failed load
+  ASSERT_EQ(0x50, position_value(piece::rook).as_int());
+
+  ASSERT_THROW(position_value::initialize_lookup_tables(
+                 std::string("/nonexistent/kator/parameters.conf")),
+               std::runtime_error);
+}
+
+TEST_F(engine_eval_parameters, evaluator)
+{
+  // A rook ahead, not a known endgame
+  auto state = ::kator::parse_fen("4k3/pppp4/8/8/8/8/PPPP4/R3K3 w - - 0 1");
+  const ::kator::position& position = *state->position;
+  ::kator::engine::evaluator eval;
+
+  position_value before = eval.evaluate(position);
+  ASSERT_EQ(before.as_int(), eval.evaluate(position).as_int());
+  ASSERT_EQ(1u, eval.cache_hit_count());
+
+  // Nothing computed with the previous rook value is reused
+  std::istringstream text("rook = 0x40\n");
+  position_value::initialize_lookup_tables(text);
+  position_value after = eval.evaluate(position);
+  ASSERT_EQ(before.as_int() - 0x10, after.as_int());
+  ASSERT_EQ(0u, eval.cache_hit_count());
+}
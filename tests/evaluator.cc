@@ -0,0 +1,90 @@
+
+#include "gtest.h"
+#include "chess/game_state.h"
+#include "engine/evaluator.h"
+
+#include <cstdlib>
+#include <vector>
+
+using namespace ::kator;
+using ::kator::engine::evaluator;
+using ::kator::engine::position_value;
+
+TEST(engine_evaluator, lazy)
+{
+  // A queen ahead, with some pawn structure
+  auto state = parse_fen("4k3/pp3ppp/8/8/8/8/PP3PPP/3QK3 w - - 0 1");
+  const position& position = *state->position;
+  evaluator eval;
+  auto window = position_value::create_from_int(0x10);
+
+  position_value lazy = eval.evaluate(position, -window, window);
+  ASSERT_GT(lazy.as_int(), window.as_int());
+  ASSERT_EQ(1u, eval.lazy_exit_count());
+  ASSERT_EQ(0u, eval.full_evaluation_count());
+
+  // Lazy values are not cached
+  position_value full = eval.evaluate(position);
+  ASSERT_EQ(1u, eval.full_evaluation_count());
+  ASSERT_LE(std::abs(full.as_int() - lazy.as_int()),
+            position_value::get_lazy_margin().midgame());
+
+  // Inside the window, the evaluation is complete
+  eval.clear();
+  auto wide = position_value::create_from_int(0x100);
+  ASSERT_EQ(full.as_int(), eval.evaluate(position, -wide, wide).as_int());
+  ASSERT_EQ(0u, eval.lazy_exit_count());
+}
+
+namespace
+{
+
+const char* const batch_fens[] = {
+  starting_fen,
+  "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+  "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1",
+  "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+  "8/8/8/2k5/3Pp3/8/8/4K3 b - d3 0 1",
+  "4k3/pp3ppp/8/8/8/8/PP3PPP/3QK3 w - - 0 1",
+  "8/8/8/3k4/8/8/R7/K7 w - - 0 1"
+};
+
+constexpr size_t batch_fen_count = sizeof(batch_fens) / sizeof(batch_fens[0]);
+
+void check_batch(size_t count, unsigned thread_count)
+{
+  std::vector<std::unique_ptr<game_state>> states;
+  std::vector<const position*> positions;
+
+  for (size_t i = 0; i < count; ++i) {
+    states.push_back(parse_fen(batch_fens[i % batch_fen_count]));
+    positions.push_back(states.back()->position.get());
+  }
+
+  std::vector<position_value> values(count + 1,
+                                     position_value::create_from_int(0x77));
+
+  engine::evaluate_batch(positions.data(), count, values.data(), thread_count);
+  for (size_t i = 0; i < count; ++i) {
+    evaluator eval;
+    ASSERT_EQ(eval.evaluate(*positions[i]).as_int(), values[i].as_int());
+  }
+
+  // Nothing is written past the last position
+  ASSERT_EQ(0x77, values[count].as_int());
+}
+
+}
+
+TEST(engine_evaluator, batch)
+{
+  for (unsigned thread_count : {1u, 3u, 0u}) {
+    check_batch(batch_fen_count, thread_count);
+  }
+
+  // Fewer positions than threads, and no positions at all
+  check_batch(2, 8);
+  check_batch(1, 0);
+  check_batch(0, 4);
+  check_batch(0, 1);
+}
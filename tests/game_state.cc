@@ -2,6 +2,9 @@
 #include "gtest.h"
 #include "chess/move.h"
 #include "chess/game_state.h"
+#include "platform/block_pool.h"
+
+#include <vector>
 
 using namespace ::kator;
 
@@ -530,3 +533,24 @@ TEST(chess_game_state, make_move)
   ASSERT_FALSE(state->en_passant_target_square.is_set());
 }
 
+
+TEST(chess_game_state, pooled_allocation)
+{
+  std::vector<std::unique_ptr<game_state>> states;
+  std::vector<const void*> addresses;
+
+  for (unsigned i = 0; i < 32; ++i) {
+    states.push_back(parse_fen(starting_fen));
+    addresses.push_back(states.back().get());
+  }
+  states.clear();
+
+  // The pool hands out the most recently freed block first
+  for (unsigned i = 0; i < 32; ++i) {
+    void* block = block_pool_allocate(sizeof(game_state));
+    ASSERT_EQ(addresses[31 - i], block);
+  }
+  for (auto address : addresses) {
+    block_pool_deallocate(const_cast<void*>(address), sizeof(game_state));
+  }
+}
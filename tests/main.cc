@@ -12,8 +12,6 @@ std::ostream& operator<< (std::ostream& stream, ::kator::move move)
 
 int main(int argc, char** argv)
 {
-  ::kator::bitboard_lookup_tables_init();
-  ::kator::engine::position_value::default_initialize_lookup_tables();
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
 }
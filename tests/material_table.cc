@@ -0,0 +1,59 @@
+
+#include "gtest.h"
+#include "chess/game_state.h"
+#include "engine/material_table.h"
+#include "engine/evaluator.h"
+
+using namespace ::kator;
+using ::kator::engine::material_entry;
+using ::kator::engine::material_table;
+using ::kator::engine::position_value;
+
+TEST(engine_material_table, probe)
+{
+  auto state = parse_fen(starting_fen);
+  const position& position = *state->position;
+  material_table table(4);
+
+  const material_entry& entry = table.probe(position);
+  ASSERT_EQ(position.get_material_key().get_value(), entry.key);
+  ASSERT_EQ(max_game_phase, entry.phase);
+  ASSERT_TRUE(entry.imbalance == psq_score());
+  ASSERT_EQ(nullptr, entry.endgame);
+  ASSERT_EQ(material_entry::normal_scale, entry.scale[0]);
+  ASSERT_EQ(&entry, &table.probe(position));
+
+  // Only the opponent has the bishop pair
+  auto pair = parse_fen("4k3/8/3bb3/8/8/3B4/8/4K3 w - - 0 1");
+  const material_entry& pair_entry = table.probe(*pair->position);
+  ASSERT_TRUE(pair_entry.imbalance.midgame() < 0);
+  ASSERT_EQ(3u, pair_entry.phase);
+  ASSERT_EQ(0u, pair_entry.scale[offset(player_to_move)]);
+}
+
+TEST(engine_material_table, endgames)
+{
+  material_table table(4);
+  engine::evaluator evaluator;
+
+  // The opponent has the rook
+  auto krk = parse_fen("4k3/8/8/8/3r4/8/8/K7 w - - 0 1");
+  const material_entry& krk_entry = table.probe(*krk->position);
+  ASSERT_EQ(&engine::evaluate_krk, krk_entry.endgame);
+  ASSERT_EQ(player_opponent, krk_entry.strong_side);
+
+  // Pushing the lone king to the edge is better for the rook side
+  auto center = parse_fen("8/8/8/3k4/8/8/R7/K7 w - - 0 1");
+  auto edge = parse_fen("3k4/8/8/8/8/8/R7/K7 w - - 0 1");
+  position_value center_value = evaluator.evaluate(*center->position);
+  position_value edge_value = evaluator.evaluate(*edge->position);
+  ASSERT_GT(center_value.as_int(), 0);
+  ASSERT_GT(edge_value.as_int(), center_value.as_int());
+
+  // Mate with bishop and knight is forced in a corner of the bishop's color
+  auto kbnk = parse_fen("k7/8/8/8/8/8/8/KBN5 w - - 0 1");
+  auto wrong = parse_fen("7k/8/8/8/8/8/8/KBN5 w - - 0 1");
+  ASSERT_EQ(&engine::evaluate_kbnk, table.probe(*kbnk->position).endgame);
+  ASSERT_GT(evaluator.evaluate(*kbnk->position).as_int(),
+            evaluator.evaluate(*wrong->position).as_int());
+}
@@ -175,3 +175,35 @@ TEST(chess_move, knight_move)
   ASSERT_TRUE(promotion.is_irreversible());
 }
 
+
+TEST(chess_move, packed_move)
+{
+  packed_move null;
+
+  ASSERT_TRUE(null.is_null());
+  ASSERT_EQ(packed_move::null(), null);
+
+  packed_move push(move(e2, e4, piece::pawn, move::pawn_double_push));
+
+  ASSERT_FALSE(push.is_null());
+  ASSERT_EQ(e2, push.from());
+  ASSERT_EQ(e4, push.to());
+  ASSERT_EQ(packed_move::normal, push.flags());
+  ASSERT_EQ(push, packed_move::from_uint(push.to_uint()));
+
+  packed_move promotion(move(b7, a8, piece::rook, piece::knight,
+                             move::promotion));
+
+  ASSERT_EQ(b7, promotion.from());
+  ASSERT_EQ(a8, promotion.to());
+  ASSERT_EQ(packed_move::promotion, promotion.flags());
+  ASSERT_EQ(piece::rook, promotion.promotion_piece());
+  ASSERT_NE(promotion, packed_move(move(b7, a8, piece::queen, piece::knight,
+                                        move::promotion)));
+
+  ASSERT_EQ(packed_move::castle, packed_move(castle_kingside).flags());
+  ASSERT_EQ(packed_move::castle, packed_move(castle_queenside).flags());
+  ASSERT_EQ(packed_move::en_passant,
+            packed_move(move(e5, d6, piece::pawn, piece::pawn,
+                             move::en_passant)).flags());
+}
@@ -0,0 +1,169 @@
+
+#include "gtest.h"
+#include "chess/move.h"
+#include "chess/move_list.h"
+#include "chess/game_state.h"
+
+#include <vector>
+
+using namespace ::kator;
+
+namespace
+{
+
+const char* const test_fens[] = {
+  "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+  "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+  "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+  "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1",
+  "n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1",
+  "8/8/8/2k5/3Pp3/8/8/4K3 b - d3 0 1",
+  "4k3/8/8/8/1b6/8/8/R3K2R w KQ - 0 1",
+  "4k3/8/8/8/8/8/3r1n2/R3K2R w KQ - 0 1"
+};
+
+const char* const check_fens[] = {
+  "5k2/8/8/8/8/8/8/4K2R w K - 0 1",
+  "3k4/8/8/8/8/8/8/R3K3 w Q - 0 1",
+  "4k3/8/8/8/4N3/8/8/4R1K1 w - - 0 1",
+  "7k/8/8/8/3P4/8/1B6/6K1 w - - 0 1",
+  "2k5/4P3/8/8/8/8/8/4K3 w - - 0 1",
+  "4k3/8/8/8/8/8/4K3/4R3 w - - 0 1",
+  "8/8/4r3/8/5k2/8/4P3/4K3 w - - 0 1",
+  "r1b1k2r/ppp1qppp/2n5/3pP3/1b1Pn3/2NB1N2/PP3PPP/R1BQK2R w KQkq d6 0 8",
+  "8/8/8/8/4r3/7k/4R3/4K3 w - - 0 1"
+};
+
+}
+
+TEST(chess_move_list, captures_and_quiets)
+{
+  for (auto fen : test_fens) {
+    auto state = parse_fen(fen);
+    const position& position = *state->position;
+    move_list all(position);
+    move_list captures(position, move_generation::captures);
+    move_list quiets(position, move_generation::quiets);
+
+    ASSERT_EQ(all.count(), captures.count() + quiets.count()) << fen;
+    for (auto move : captures) {
+      ASSERT_TRUE(move.is_capture()) << fen;
+      ASSERT_TRUE(all.contains(move)) << fen;
+    }
+    for (auto move : quiets) {
+      ASSERT_FALSE(move.is_capture()) << fen;
+      ASSERT_TRUE(all.contains(move)) << fen;
+    }
+  }
+}
+
+TEST(chess_move_list, evasions)
+{
+  for (auto fen : test_fens) {
+    auto state = parse_fen(fen);
+    const position& position = *state->position;
+
+    if (position.in_check()) {
+      move_list all(position);
+      move_list evasions(position, move_generation::evasions);
+
+      ASSERT_EQ(all.count(), evasions.count()) << fen;
+      for (auto move : evasions) {
+        ASSERT_TRUE(all.contains(move)) << fen;
+      }
+    }
+  }
+}
+
+TEST(chess_move_list, en_passant_evasion)
+{
+  auto state = parse_fen("8/8/8/2k5/3Pp3/8/8/4K3 b - d3 0 1");
+
+  ASSERT_TRUE(state->in_check);
+  ASSERT_EQ(size_t(9), state->moves.count());
+  ASSERT_TRUE(state->moves.contains(
+      move(e4, d3, piece::pawn, piece::pawn, move::en_passant)));
+
+  move_list captures(*state->position, move_generation::captures);
+
+  ASSERT_EQ(size_t(2), captures.count());
+}
+
+TEST(chess_move_list, quiet_checks)
+{
+  auto check = [](const char* fen) {
+    auto state = parse_fen(fen);
+    const position& position = *state->position;
+    move_list quiets(position, move_generation::quiets);
+    move_list checks(position, move_generation::quiet_checks);
+    size_t expected = 0;
+
+    for (auto move : quiets) {
+      if (kator::position(position, move).in_check()) {
+        ++expected;
+      }
+    }
+    ASSERT_EQ(expected, checks.count()) << fen;
+    for (auto move : checks) {
+      ASSERT_TRUE(quiets.contains(move)) << fen;
+      ASSERT_TRUE(kator::position(position, move).in_check()) << fen;
+    }
+  };
+
+  for (auto fen : test_fens) {
+    check(fen);
+  }
+  for (auto fen : check_fens) {
+    check(fen);
+  }
+}
+
+TEST(chess_move_list, count_legal_moves)
+{
+  auto check = [](const char* fen) {
+    auto state = parse_fen(fen);
+    const position& position = *state->position;
+
+    ASSERT_EQ(move_list(position).count(), count_legal_moves(position)) << fen;
+    for (auto type : { move_generation::all,
+                       move_generation::captures,
+                       move_generation::quiets,
+                       move_generation::quiet_checks }) {
+      ASSERT_EQ(move_list(position, type).count(),
+                count_legal_moves(position, type)) << fen;
+    }
+    if (position.in_check()) {
+      ASSERT_EQ(move_list(position, move_generation::evasions).count(),
+                count_legal_moves(position, move_generation::evasions)) << fen;
+    }
+  };
+
+  for (auto fen : test_fens) {
+    check(fen);
+  }
+  for (auto fen : check_fens) {
+    check(fen);
+  }
+}
+
+TEST(chess_move_list, caller_buffer)
+{
+  for (auto fen : test_fens) {
+    auto state = parse_fen(fen);
+    const position& position = *state->position;
+    move_list list(position);
+    move array[move_list::max_size];
+    std::vector<move> vector(move_list::max_size + 4);
+
+    ASSERT_EQ(list.count(), generate_legal_moves(position, array)) << fen;
+    ASSERT_EQ(list.count(), generate_legal_moves(position, vector.data(),
+                                                 vector.size())) << fen;
+    for (size_t i = 0; i < list.count(); ++i) {
+      ASSERT_EQ(array[i], vector[i]) << fen;
+    }
+
+    ASSERT_EQ(move_list(position, move_generation::captures).count(),
+              generate_legal_moves(position, move_generation::captures,
+                                   array)) << fen;
+  }
+}
@@ -0,0 +1,91 @@
+
+#include "gtest.h"
+#include "chess/game_state.h"
+#include "engine/move_order.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace ::kator;
+using ::kator::engine::history_table;
+using ::kator::engine::scored_move_list;
+
+namespace
+{
+
+int value_of(piece piece)
+{
+  switch (piece) {
+    case piece::pawn:
+      return 1;
+    case piece::knight:
+    case piece::bishop:
+      return 3;
+    case piece::rook:
+      return 5;
+    case piece::queen:
+      return 9;
+    default:
+      return 0;
+  }
+}
+
+// The same scores as computed in vectors by scored_move_list
+int expected_score(move move, const history_table& history)
+{
+  int gain = value_of(move.captured());
+  int attacker = value_of(move.result());
+
+  if (move.is_promotion()) {
+    attacker = 1;
+    if (move.result() == piece::queen) {
+      gain += 8;
+    }
+    else if (move.result() == piece::knight) {
+      gain += 2;
+    }
+  }
+  if (gain == 0) {
+    return history.value_of(move);
+  }
+  return 0x4000 + gain * 16 - attacker;
+}
+
+}
+
+TEST(engine_move_order, scores)
+{
+  const char* fens[] = {
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1",
+    "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3"
+  };
+  history_table history;
+
+  for (auto fen : fens) {
+    auto state = parse_fen(fen);
+    scored_move_list moves;
+
+    for (auto move : state->moves) {
+      if (not move.is_capture() and not move.is_promotion()) {
+        history.reward(move, 3);
+      }
+    }
+
+    ASSERT_EQ(state->moves.count(), moves.generate(*state->position, history));
+
+    std::vector<int> expected;
+    for (size_t i = 0; i < moves.count(); ++i) {
+      ASSERT_EQ(expected_score(moves[i], history), moves.score(i));
+      expected.push_back(moves.score(i));
+    }
+    std::sort(expected.rbegin(), expected.rend());
+
+    for (auto score : expected) {
+      ASSERT_TRUE(moves.has_next());
+      move move = moves.pick_next();
+      ASSERT_EQ(expected_score(move, history), score);
+    }
+    ASSERT_FALSE(moves.has_next());
+  }
+}
@@ -0,0 +1,163 @@
+
+#include "gtest.h"
+#include "chess/game_state.h"
+#include "chess/move_list.h"
+#include "engine/nnue.h"
+#include "engine/evaluator.h"
+
+#include <random>
+#include <sstream>
+#include <vector>
+
+using namespace ::kator;
+using ::kator::engine::nnue_accumulator;
+using ::kator::engine::nnue_network;
+
+namespace
+{
+
+template<typename type>
+void write_random(std::ostream& stream, size_t count,
+                  std::mt19937& random, int low, int high)
+{
+  std::vector<type> values(count);
+
+  for (auto& value : values) {
+    value = static_cast<type>(low + int(random() % unsigned(high - low + 1)));
+  }
+  stream.write(reinterpret_cast<const char*>(values.data()),
+               std::streamsize(count * sizeof(type)));
+}
+
+std::unique_ptr<nnue_network> random_network()
+{
+  std::stringstream stream;
+  std::mt19937 random(1);
+  const uint32_t dimensions[] = {
+    nnue_network::feature_count, nnue_network::width,
+    nnue_network::hidden_width
+  };
+  const unsigned width = nnue_network::width;
+  const unsigned hidden_width = nnue_network::hidden_width;
+
+  stream.write("KATORNN1", 8);
+  stream.write(reinterpret_cast<const char*>(dimensions), sizeof(dimensions));
+  write_random<int16_t>(stream, size_t(nnue_network::feature_count) * width,
+                        random, -8, 8);
+  write_random<int16_t>(stream, width, random, 0, 32);
+  write_random<int16_t>(stream, size_t(hidden_width) * 2 * width,
+                        random, -16, 16);
+  write_random<int32_t>(stream, hidden_width, random, -256, 256);
+  write_random<int16_t>(stream, hidden_width, random, -64, 64);
+  write_random<int32_t>(stream, 1, random, -256, 256);
+  return nnue_network::load(stream);
+}
+
+void check_update(const nnue_network& network,
+                  const position& position,
+                  const nnue_accumulator& accumulator,
+                  unsigned depth)
+{
+  for (auto move : move_list(position)) {
+    class position child(position, move);
+    nnue_accumulator updated;
+    nnue_accumulator refreshed;
+
+    network.update(position, accumulator, child, updated);
+    network.refresh(child, refreshed);
+    ASSERT_EQ(refreshed.values, updated.values);
+    if (depth > 1) {
+      check_update(network, child, updated, depth - 1);
+    }
+  }
+}
+
+}
+
+TEST(engine_nnue, load)
+{
+  std::stringstream garbage("KATORNN0 and then some");
+
+  ASSERT_THROW(nnue_network::load(garbage), std::runtime_error);
+
+  std::stringstream truncated;
+  const uint32_t dimensions[] = {
+    nnue_network::feature_count, nnue_network::width,
+    nnue_network::hidden_width
+  };
+  truncated.write("KATORNN1", 8);
+  truncated.write(reinterpret_cast<const char*>(dimensions),
+                  sizeof(dimensions));
+  ASSERT_THROW(nnue_network::load(truncated), std::runtime_error);
+}
+
+TEST(engine_nnue, incremental_update)
+{
+  auto network = random_network();
+  const char* const fens[] = {
+    // castling, promotions with captures, en passant
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1",
+    "8/8/8/2k5/3Pp3/8/8/4K3 b - d3 0 1"
+  };
+
+  for (auto fen : fens) {
+    auto state = parse_fen(fen);
+    nnue_accumulator accumulator;
+
+    network->refresh(*state->position, accumulator);
+    check_update(*network, *state->position, accumulator, 2);
+  }
+}
+
+// Installs a network for the duration of a test, even a failing one
+class engine_nnue_active : public ::testing::Test
+{
+protected:
+
+  void SetUp() override
+  {
+    nnue_network::set_active(random_network());
+  }
+
+  void TearDown() override
+  {
+    nnue_network::set_active(nullptr);
+  }
+
+};
+
+TEST_F(engine_nnue_active, evaluator)
+{
+  auto state = parse_fen(starting_fen);
+  const position& position = *state->position;
+
+  const nnue_network& network = *nnue_network::active();
+  nnue_accumulator accumulator;
+  network.refresh(position, accumulator);
+
+  engine::evaluator eval;
+  ASSERT_EQ(network.evaluate(accumulator).as_int(),
+            eval.evaluate(position).as_int());
+  eval.clear();
+  ASSERT_EQ(network.evaluate(position).as_int(),
+            eval.evaluate(position, accumulator).as_int());
+}
+
+TEST_F(engine_nnue_active, switching)
+{
+  auto state = parse_fen(starting_fen);
+  const position& position = *state->position;
+
+  engine::evaluator eval;
+
+  nnue_network::set_active(nullptr);
+  engine::position_value handcrafted = engine::evaluator().evaluate(position);
+  ASSERT_EQ(handcrafted.as_int(), eval.evaluate(position).as_int());
+
+  // An evaluator created earlier uses the network set later
+  nnue_network::set_active(random_network());
+  eval.clear();
+  ASSERT_EQ(nnue_network::active()->evaluate(position).as_int(),
+            eval.evaluate(position).as_int());
+}
@@ -0,0 +1,56 @@
+
+#include "gtest.h"
+#include "chess/game_state.h"
+#include "engine/pawn_table.h"
+
+using namespace ::kator;
+using ::kator::engine::pawn_entry;
+using ::kator::engine::pawn_table;
+
+TEST(engine_pawn_table, probe)
+{
+  // Passed pawns on d5 and f7, an isolated pawn on h2, doubled b pawns
+  auto state = parse_fen("4k3/p4p2/1p4p1/3P4/8/1P6/1P5P/4K3 w - - 0 1");
+  const position& position = *state->position;
+  pawn_table table(10);
+
+  const pawn_entry& entry = table.probe(position);
+  ASSERT_EQ(0u, table.hit_count());
+  ASSERT_EQ(1u, table.miss_count());
+  ASSERT_EQ(position.get_pawn_zhash().get_value(), entry.key);
+  ASSERT_EQ(bitboard(d5), entry.passed);
+  ASSERT_EQ(bitboard(f7), entry.opponent_passed);
+
+  /* White: b2 doubled, all four pawns isolated, d5 passed on the {{{
+     fifth rank -- black: f7 passed on its second rank.
+  }}}*/
+  ASSERT_EQ(-7, entry.score.midgame());
+  ASSERT_EQ(-10, entry.score.endgame());
+
+  // b2, b3 on the queenside, h2 on the kingside
+  ASSERT_EQ(5, entry.shields[pawn_entry::queenside]);
+  ASSERT_EQ(3, entry.shields[pawn_entry::kingside]);
+  ASSERT_EQ(5, entry.opponent_shields[pawn_entry::queenside]);
+  ASSERT_EQ(5, entry.opponent_shields[pawn_entry::kingside]);
+
+  // The same structure seen by the other player
+  auto flipped = state->make_move(state->parse_move("e1d1"));
+  const pawn_entry& other = table.probe(*flipped->position);
+  ASSERT_EQ(2u, table.miss_count());
+  ASSERT_EQ(7, other.score.midgame());
+  ASSERT_EQ(10, other.score.endgame());
+  ASSERT_EQ(flip(entry.passed), other.opponent_passed);
+  ASSERT_EQ(entry.opponent_shields, other.shields);
+  ASSERT_EQ(entry.shields, other.opponent_shields);
+
+  // A king move keeps the pawn structure, thus the entry
+  auto king_moved = flipped->make_move(flipped->parse_move("e8d8"));
+  table.probe(*king_moved->position);
+  ASSERT_EQ(1u, table.hit_count());
+  ASSERT_EQ(2u, table.miss_count());
+
+  table.clear();
+  table.probe(position);
+  ASSERT_EQ(0u, table.hit_count());
+  ASSERT_EQ(1u, table.miss_count());
+}
@@ -251,4 +251,6 @@ add_test("move_generator_perftsuite_124"
          ../kator --test_file ${CMAKE_SOURCE_DIR}/tests/perftsuite/perft_124 )
 add_test("move_generator_perftsuite_125"
          ../kator --test_file ${CMAKE_SOURCE_DIR}/tests/perftsuite/perft_125 )
+add_test("move_generator_perftsuite_126"
+         ../kator --test_file ${CMAKE_SOURCE_DIR}/tests/perftsuite/perft_126 )
 
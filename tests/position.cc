@@ -0,0 +1,232 @@
+
+#include "gtest.h"
+#include "chess/move.h"
+#include "chess/move_list.h"
+#include "chess/game_state.h"
+
+using namespace ::kator;
+
+namespace
+{
+
+void check_key_after(const position& position, unsigned depth)
+{
+  for (auto move : move_list(position)) {
+    class position child(position, move);
+
+    ASSERT_EQ(child.get_zhash().get_value(),
+              position.key_after(move).get_value());
+    if (depth > 1) {
+      check_key_after(child, depth - 1);
+    }
+  }
+}
+
+psq_score psq_from_scratch(const position& position)
+{
+  psq_score sum;
+
+  for (auto index : position.occupied()) {
+    sum += piece_square_table[position.square_at(index)][index.offset()];
+  }
+  return sum;
+}
+
+unsigned phase_from_scratch(const position& position)
+{
+  unsigned phase = 0;
+
+  for (auto index : position.occupied()) {
+    phase += phase_weight(position.piece_at(index));
+  }
+  return phase;
+}
+
+pawn_hash pawn_zhash_from_scratch(const position& position)
+{
+  pawn_hash key;
+
+  for (auto index : position.occupied()) {
+    key.xor_piece(position.square_at(index), index);
+  }
+  return key;
+}
+
+material_key material_key_from_scratch(const position& position)
+{
+  material_key key;
+
+  for (auto index : position.occupied()) {
+    key.add(position.square_at(index));
+  }
+  return key;
+}
+
+void check_psq_score(const position& position, unsigned depth)
+{
+  for (auto move : move_list(position)) {
+    class position child(position, move);
+
+    ASSERT_TRUE(psq_from_scratch(child) == child.piece_square_score());
+    ASSERT_EQ(phase_from_scratch(child), child.game_phase());
+    ASSERT_EQ(pawn_zhash_from_scratch(child).get_value(),
+              child.get_pawn_zhash().get_value());
+    ASSERT_EQ(material_key_from_scratch(child).get_value(),
+              child.get_material_key().get_value());
+    if (depth > 1) {
+      check_psq_score(child, depth - 1);
+    }
+  }
+}
+
+std::unique_ptr<game_state>
+play(const char* fen, std::initializer_list<const char*> moves)
+{
+  auto state = parse_fen(fen);
+
+  for (auto move : moves) {
+    state = state->make_move(state->parse_move(move));
+  }
+  return state;
+}
+
+}
+
+TEST(chess_position, key_after)
+{
+  const char* const fens[] = {
+    starting_fen,
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "8/8/8/2k5/3Pp3/8/8/4K3 b - d3 0 1"
+  };
+
+  for (auto fen : fens) {
+    auto state = parse_fen(fen);
+
+    check_key_after(*state->position, 3);
+  }
+}
+
+TEST(chess_position, piece_square_score)
+{
+  const char* const fens[] = {
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1",
+    "8/8/8/2k5/3Pp3/8/8/4K3 b - d3 0 1"
+  };
+
+  auto start = parse_fen(starting_fen);
+
+  ASSERT_TRUE(psq_score() == start->position->piece_square_score());
+  ASSERT_EQ(max_game_phase, start->position->game_phase());
+
+  for (int midgame : {-300, -1, 0, 7, 300}) {
+    for (int endgame : {-300, -1, 0, 5, 300}) {
+      psq_score score(midgame, endgame);
+
+      ASSERT_EQ(midgame, score.midgame());
+      ASSERT_EQ(endgame, score.endgame());
+      ASSERT_TRUE(psq_score(2 * midgame, 2 * endgame) == score + score);
+      ASSERT_TRUE(psq_score(-midgame, -endgame) == -score);
+    }
+  }
+
+  for (auto fen : fens) {
+    auto state = parse_fen(fen);
+
+    ASSERT_TRUE(psq_from_scratch(*state->position)
+                == state->position->piece_square_score());
+    check_psq_score(*state->position, 3);
+  }
+}
+
+TEST(chess_position, zhash_transpositions)
+{
+  auto a = play(starting_fen, { "g1f3", "g8f6", "e2e4" });
+  auto b = play(starting_fen, { "e2e4", "g8f6", "g1f3" });
+  auto c = parse_fen(
+      "rnbqkb1r/pppppppp/5n2/8/4P3/5N2/PPPP1PPP/RNBQKB1R b KQkq - 1 2");
+
+  ASSERT_EQ(a->position->get_zhash().get_value(),
+            b->position->get_zhash().get_value());
+  ASSERT_EQ(a->position->get_zhash().get_value(),
+            c->position->get_zhash().get_value());
+
+  /* Same placement, different castling rights */
+  auto d = play(starting_fen,
+                { "g1f3", "g8f6", "h1g1", "f6g8", "g1h1", "g8f6", "e2e4" });
+
+  ASSERT_NE(a->position->get_zhash().get_value(),
+            d->position->get_zhash().get_value());
+
+  /* Same placement, with and without en passant */
+  auto e = play("4k3/8/8/8/4p3/8/3P4/4K3 w - - 0 1", { "d2d4" });
+  auto f = parse_fen("4k3/8/8/8/3Pp3/8/8/4K3 b - - 0 1");
+  auto g = parse_fen("4k3/8/8/8/3Pp3/8/8/4K3 b - d3 0 1");
+
+  ASSERT_NE(e->position->get_zhash().get_value(),
+            f->position->get_zhash().get_value());
+  ASSERT_EQ(e->position->get_zhash().get_value(),
+            g->position->get_zhash().get_value());
+}
+
+TEST(chess_position, is_pseudo_legal)
+{
+  const char* const fens[] = {
+    starting_fen,
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "8/8/8/2k5/3Pp3/8/8/4K3 b - d3 0 1",
+    "n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1",
+    "4k3/8/8/8/1b6/8/8/R3K2R w KQ - 0 1"
+  };
+
+  for (auto fen : fens) {
+    auto state = parse_fen(fen);
+    const position& position = *state->position;
+    move_list moves(position);
+    size_t legal_count = 0;
+
+    for (auto move : moves) {
+      packed_move packed(move);
+
+      ASSERT_TRUE(position.is_pseudo_legal(packed)) << fen;
+
+      class move unpacked = position.unpack(packed);
+
+      ASSERT_EQ(move, unpacked) << fen;
+      ASSERT_EQ(move.move_type, unpacked.move_type) << fen;
+      ASSERT_EQ(move.captured(), unpacked.captured()) << fen;
+    }
+
+    /* Every other 16 bit value must either be rejected, or leave
+       the king of the player making the move in check ( or be
+       a legal move with some unused bits set ) */
+    for (unsigned raw = 0; raw < (1u << packed_move::bits); ++raw) {
+      packed_move packed = packed_move::from_uint(raw);
+
+      if (not position.is_pseudo_legal(packed)) {
+        continue;
+      }
+
+      move move = position.unpack(packed);
+
+      if (moves.contains(move)) {
+        if (packed_move(move) == packed) {
+          ++legal_count;
+        }
+      }
+      else {
+        class position child(position, move);
+
+        ASSERT_TRUE(child.is_attacked_by(player_to_move,
+                                         child.opponent_king_index()))
+          << fen << " " << raw;
+      }
+    }
+    ASSERT_EQ(moves.count(), legal_count) << fen;
+  }
+}
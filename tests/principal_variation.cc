@@ -0,0 +1,36 @@
+
+#include "gtest.h"
+#include "chess/game_state.h"
+#include "engine/principal_variation.h"
+
+using namespace ::kator;
+using ::kator::engine::principal_variation;
+
+TEST(engine_principal_variation, lines)
+{
+  auto state = parse_fen(starting_fen);
+  move moves[move_list::max_size];
+  size_t count = generate_legal_moves(*state->position, moves);
+
+  ASSERT_EQ(20u, count);
+  ASSERT_EQ(state->moves.count(), count);
+  ASSERT_LT(sizeof(principal_variation), sizeof(move_list) / 3);
+
+  principal_variation child;
+  for (size_t i = 0; i < principal_variation::max_length + 5; ++i) {
+    child.push_back(moves[i % count]);
+  }
+  ASSERT_EQ(size_t(principal_variation::max_length), child.size());
+
+  child.clear();
+  ASSERT_TRUE(child.empty());
+  child.push_back(moves[1]);
+  child.push_back(moves[2]);
+
+  principal_variation pv;
+  pv.assign(moves[0], child);
+  ASSERT_EQ(3u, pv.size());
+  for (size_t i = 0; i < pv.size(); ++i) {
+    ASSERT_EQ(moves[i], pv[i]);
+  }
+}
@@ -0,0 +1,53 @@
+
+#include "gtest.h"
+#include "chess/game_state.h"
+#include "engine/search_stack.h"
+
+#include <cstdint>
+
+using namespace ::kator;
+using ::kator::engine::search_stack;
+using ::kator::engine::node;
+using ::kator::engine::history_table;
+
+namespace
+{
+
+void check_frames(search_stack& stack,
+                  unsigned ply,
+                  const position& expected,
+                  unsigned depth)
+{
+  node& frame = stack[ply];
+
+  ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(&frame) % cache_line_size);
+  ASSERT_EQ(expected.get_zhash().get_value(),
+            frame.position.get_zhash().get_value());
+  ASSERT_EQ(expected.occupied(), frame.position.occupied());
+
+  frame.generate_moves(history_table());
+  ASSERT_EQ(move_list(expected).count(), frame.moves.count());
+  if (depth == 0) {
+    return;
+  }
+
+  for (auto move : move_list(expected)) {
+    node& child = stack.set_up_child(ply, move);
+
+    ASSERT_EQ(&stack[ply + 1], &child);
+    ASSERT_EQ(-frame.alpha.as_int(), child.beta.as_int());
+    check_frames(stack, ply + 1, position(expected, move), depth - 1);
+  }
+}
+
+}
+
+TEST(engine_search_stack, frames)
+{
+  auto state = parse_fen(
+      "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+  search_stack stack(*parse_fen(starting_fen)->position);
+
+  stack.set_up_root(*state->position);
+  check_frames(stack, 0, *state->position, 2);
+}
@@ -0,0 +1,485 @@
+
+/* Generating the bitboard lookup tables at build time. {{{
+   The output is included by src/chess/bitboard.cc, defining all the
+   attack tables as constant data. This way the tables end up in the
+   read-only data section of the executable, there is nothing to compute
+   at startup, and the pages are shared by all kator processes running.
+   The sliding attack tables are laid out according to the magic
+   constants in src/chess/magics.inc, or -- in a pext build -- packed
+   one square after the other. With magics, the table indexed by the
+   magic holds bytes, each selecting one of the distinct attack sets
+   of the square, which are stored in a separate table.
+   This program only relies on the inline parts of bitboard.h, it must
+   not use the tables it generates.
+
+   usage: kator_attack_table_generator attack_tables.inc
+}}}*/
+
+#include "chess/bitboard.h"
+
+#include <algorithm>
+#include <array>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace ::kator;
+
+namespace
+{
+
+#ifdef KATOR_USE_PEXT_BITBOARD
+
+typedef std::remove_const< std::remove_reference<
+            decltype(*bitboard::magical::attacks)>::type
+        >::type sliding_attack_t;
+
+#else
+
+struct magic_constant
+{
+  uint64_t multiplier;
+  unsigned shift;
+  size_t offset;
+};
+
+#include "chess/magics.inc"
+
+#endif
+
+const std::array<sq_index::direction, 8> king_directions({
+  {north, north + east, north + west, west,
+  south, south + east, south + west, east}
+});
+
+const std::array<sq_index::direction, 8> knigth_directions({
+  {north + north + west,
+  north + north + east,
+  north + west + west,
+  north + east + east,
+  south + south + west,
+  south + south + east,
+  south + west + west,
+  south + east + east}
+});
+
+struct sliding_direction
+{
+  sq_index::direction delta;
+  bitboard pre_mask_edge;
+  bitboard attack_edge;
+};
+
+typedef std::array<sliding_direction, 4> sliding_directions;
+
+const sliding_directions rook_directions = {{
+  { east,  bitboard(file_h), bitboard(file_a) },
+  { west,  bitboard(file_a), bitboard(file_h) },
+  { north, bitboard(rank_8), bitboard(rank_1) },
+  { south, bitboard(rank_1), bitboard(rank_8) }
+}};
+
+const sliding_directions bishop_directions = {{
+  { east + north,
+    bitboard(file_h) | bitboard(rank_8),
+    bitboard(file_a) | bitboard(rank_1)
+  },
+  { west + north,
+    bitboard(file_a) | bitboard(rank_8),
+    bitboard(file_h) | bitboard(rank_1)
+  },
+  { east + south,
+    bitboard(file_h) | bitboard(rank_1),
+    bitboard(file_a) | bitboard(rank_8)
+  },
+  { west + south,
+    bitboard(file_a) | bitboard(rank_1),
+    bitboard(file_h) | bitboard(rank_8)
+  }
+}};
+
+void generate_simple_table(std::array<bitboard, 64>& attack_patterns,
+                           const std::array<sq_index::direction, 8>& directions)
+{
+  attack_patterns.fill(bitboard::empty());
+  for (auto index : sq_index::range()) {
+    for (auto direction : directions) {
+      if (index.stays_in_board(direction)) {
+        attack_patterns[index.offset()].set_bit(index + direction);
+      }
+    }
+  }
+}
+
+bitboard generate_ray(sq_index src_index,
+                      bitboard occupied,
+                      sliding_direction direction)
+{
+  bitboard result = bitboard::empty();
+  sq_index index = src_index + direction.delta;
+
+  while (index.is_valid() and !direction.attack_edge.is_bit_set(index)) {
+    result.set_bit(index);
+    if (occupied.is_bit_set(index)) {
+      return result;
+    }
+    index += direction.delta;
+  }
+  return result;
+}
+
+bitboard generate_move_pattern(sq_index src_index,
+                               bitboard occupied,
+                               const sliding_directions& directions)
+{
+    return generate_ray(src_index, occupied, directions[0])
+         | generate_ray(src_index, occupied, directions[1])
+         | generate_ray(src_index, occupied, directions[2])
+         | generate_ray(src_index, occupied, directions[3]);
+}
+
+void generate_bishop_patterns(std::array<bitboard, 64>& attack_patterns)
+{
+  for (auto index : sq_index::range()) {
+    attack_patterns[index.offset()] =
+      generate_move_pattern(index, bitboard::empty(), bishop_directions);
+  }
+}
+
+void generate_rook_patterns(std::array<bitboard, 64>& attack_patterns)
+{
+  for (auto index : sq_index::range()) {
+    attack_patterns[index.offset()] =
+      bitboard(index.file()) | bitboard(index.rank());
+  }
+}
+
+void add_rays(std::array<bitboard, 64*64>& rays,
+              sq_index source,
+              sq_index::direction direction)
+{
+  bitboard ray = bitboard::empty();
+  sq_index index = source;
+
+  while (index.stays_in_board(direction)) {
+    index += direction;
+
+    rays[source.offset() * 64 + index.offset()] = ray;
+    rays[index.offset() * 64 + source.offset()] = ray;
+    ray.set_bit(index);
+  }
+}
+
+void generate_ray_constants(std::array<bitboard, 64*64>& rays)
+{
+  rays.fill(bitboard::empty());
+  for (auto index : sq_index::range()) {
+    add_rays(rays, index, south);
+    add_rays(rays, index, west);
+    add_rays(rays, index, south + west);
+    add_rays(rays, index, south + east);
+  }
+}
+
+bitboard generate_pre_mask_ray(sq_index index,
+                               const sliding_direction& direction)
+{
+  bitboard result = bitboard::empty();
+  index += direction.delta;
+
+  while (!direction.pre_mask_edge.is_bit_set(index)) {
+    result.set_bit(index);
+    index += direction.delta;
+  }
+  return result;
+}
+
+uint64_t generate_pre_mask(sq_index source,
+                           const sliding_directions& directions)
+{
+  bitboard result = bitboard::empty();
+
+  for (auto direction : directions) {
+    if (not direction.pre_mask_edge.is_bit_set(source)) {
+      result.merge(generate_pre_mask_ray(source, direction));
+    }
+  }
+  return result.to_uint64_t();
+}
+
+#ifdef KATOR_USE_PEXT_BITBOARD
+uint64_t generate_post_mask(sq_index source,
+                           const sliding_directions& directions)
+{
+  bitboard result = bitboard::empty();
+
+  for (auto direction : directions) {
+    result.merge(generate_ray(source, bitboard::empty(), direction));
+  }
+  return result.to_uint64_t();
+}
+#endif
+
+void generate_occupancies(sq_index source,
+                          std::vector<bitboard>& occupancies,
+                          bitboard mask)
+{
+  bitboard subset = bitboard::empty();
+
+  do {
+    occupancies.push_back(subset | bitboard(source));
+    mask.generate_next_subset(subset);
+  } while (!subset.is_empty());
+}
+
+/* The pre_mask, post_mask or multiplier, and the offset of each {{{
+   square's attacks in the shared table -- with magics, also the
+   offset of the square's distinct attack sets.
+}}}*/
+struct sliding_square
+{
+  uint64_t pre_mask;
+  uint64_t post_mask;
+  uint64_t multiplier;
+  unsigned shift;
+  size_t offset;
+  size_t attack_set_offset;
+};
+
+typedef std::array<sliding_square, 64> sliding_squares;
+
+#ifdef KATOR_USE_PEXT_BITBOARD
+
+void generate_sliding_attacks(std::vector<sliding_attack_t>& attack_table,
+                              sliding_squares& squares,
+                              const sliding_directions& directions)
+{
+  for (auto index : sq_index::range()) {
+    std::vector<bitboard> occupancies;
+    sliding_square& square = squares[index.offset()];
+
+    square.pre_mask = generate_pre_mask(index, directions);
+    square.post_mask = generate_post_mask(index, directions);
+    square.offset = attack_table.size();
+    generate_occupancies(index, occupancies, bitboard(square.pre_mask));
+
+    size_t size = size_t(1) << bitboard(square.pre_mask).popcnt();
+
+    attack_table.resize(square.offset + size, 0);
+    for (auto occupied : occupancies) {
+      size_t offset = occupied.pext(bitboard(square.pre_mask));
+      bitboard attacks = generate_move_pattern(index, occupied, directions);
+
+      attack_table[square.offset + offset] =
+        static_cast<sliding_attack_t>(attacks.pext(bitboard(square.post_mask)));
+    }
+  }
+}
+
+#else
+
+/* The attacks of all rook and bishop squares share one table. {{{
+   The offsets in the magic constants place the table of each square,
+   these overlap where all but one of them are unused, marked by -1
+   while generating. The entries are indices into the attack sets of
+   the square, thus entries of different squares can not be shared.
+   See tools/magic_generator.cc
+}}}*/
+bool generate_sliding_attacks(std::vector<int>& attack_indices,
+                              std::vector<uint64_t>& attack_sets,
+                              sliding_squares& squares,
+                              const std::array<magic_constant, 64>& constants,
+                              const sliding_directions& directions)
+{
+  attack_indices.resize(magic_attack_table_size, -1);
+
+  for (auto index : sq_index::range()) {
+    std::vector<bitboard> occupancies;
+    sliding_square& square = squares[index.offset()];
+    const magic_constant& constant = constants[index.offset()];
+
+    square.pre_mask = generate_pre_mask(index, directions);
+    square.multiplier = constant.multiplier;
+    square.shift = constant.shift;
+    square.offset = constant.offset;
+    square.attack_set_offset = attack_sets.size();
+    generate_occupancies(index, occupancies, bitboard(square.pre_mask));
+
+    for (auto occupied : occupancies) {
+      uint64_t product =
+        (occupied.to_uint64_t() & square.pre_mask) * square.multiplier;
+      size_t offset = constant.offset + (product >> square.shift);
+      uint64_t attacks =
+        generate_move_pattern(index, occupied, directions).to_uint64_t();
+      auto first = attack_sets.begin() + long(square.attack_set_offset);
+      int attack_index = int(std::find(first, attack_sets.end(), attacks)
+                             - first);
+
+      if (first + attack_index == attack_sets.end()) {
+        attack_sets.push_back(attacks);
+      }
+      if (attack_index > UINT8_MAX
+          or offset >= attack_indices.size()
+          or (attack_indices[offset] != -1
+              and attack_indices[offset] != attack_index)) {
+        std::fprintf(stderr, "invalid magic multiplier for square %u\n",
+                     index.offset());
+        return false;
+      }
+      attack_indices[offset] = attack_index;
+    }
+  }
+  return true;
+}
+
+#endif
+
+void print_table(FILE* output,
+                 const char* name,
+                 const bitboard* table,
+                 size_t size)
+{
+  std::fprintf(output, "const std::array<bitboard, %zu> %s = {{\n",
+               size, name);
+  for (size_t i = 0; i < size; ++i) {
+    std::fprintf(output, "  bitboard(UINT64_C(0x%016" PRIX64 "))%s\n",
+                 table[i].to_uint64_t(), (i + 1 < size) ? "," : "");
+  }
+  std::fprintf(output, "}};\n\n");
+}
+
+template<typename T>
+void print_attack_table(FILE* output,
+                        const char* type,
+                        const char* name,
+                        const std::vector<T>& table)
+{
+  std::fprintf(output, "static const %s %s[%zu] = {", type, name,
+               table.size());
+  for (size_t i = 0; i < table.size(); ++i) {
+    if (i % 4 == 0) {
+      std::fprintf(output, "\n ");
+    }
+    std::fprintf(output, " 0x%0*" PRIX64 "%s",
+                 static_cast<int>(sizeof(T) * 2),
+                 static_cast<uint64_t>(table[i]),
+                 (i + 1 < table.size()) ? "," : "");
+  }
+  std::fprintf(output, "\n};\n\n");
+}
+
+/* The members must be printed in the order of their declaration */
+void print_magics(FILE* output,
+                  const char* name,
+                  const char* attack_table_name,
+                  const sliding_squares& squares)
+{
+  std::fprintf(output, "const std::array<bitboard::magical, 64> %s = {{\n",
+               name);
+  for (size_t i = 0; i < squares.size(); ++i) {
+    const sliding_square& square = squares[i];
+
+#   ifdef KATOR_USE_PEXT_BITBOARD
+    std::fprintf(output, "  { UINT64_C(0x%016" PRIX64 "),"
+                         " UINT64_C(0x%016" PRIX64 "), %s + %zu }",
+                 square.pre_mask, square.post_mask,
+                 attack_table_name, square.offset);
+#   else
+    std::fprintf(output, "  { UINT64_C(0x%016" PRIX64 "),"
+                         " UINT64_C(0x%016" PRIX64 "), %s + %zu,"
+                         " magic_attack_set_table + %zu, %u }",
+                 square.pre_mask, square.multiplier,
+                 attack_table_name, square.offset,
+                 square.attack_set_offset, square.shift);
+#   endif
+    std::fprintf(output, "%s\n", (i + 1 < squares.size()) ? "," : "");
+  }
+  std::fprintf(output, "}};\n\n");
+}
+
+} /* anonym namespace */
+
+int main(int argc, char** argv)
+{
+  if (argc != 2) {
+    std::fprintf(stderr, "usage: %s attack_tables.inc\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  std::array<bitboard, 64> knight_table;
+  std::array<bitboard, 64> king_table;
+  std::array<bitboard, 64> bishop_pattern_table;
+  std::array<bitboard, 64> rook_pattern_table;
+  static std::array<bitboard, 64 * 64> rays;
+  sliding_squares rook_squares;
+  sliding_squares bishop_squares;
+
+  generate_simple_table(king_table, king_directions);
+  generate_simple_table(knight_table, knigth_directions);
+  generate_bishop_patterns(bishop_pattern_table);
+  generate_rook_patterns(rook_pattern_table);
+  generate_ray_constants(rays);
+
+#ifdef KATOR_USE_PEXT_BITBOARD
+  const char* attack_table_type = "uint16_t";
+  const char* attack_table_name = "pext_attack_table";
+  std::vector<sliding_attack_t> attack_table;
+
+  generate_sliding_attacks(attack_table, rook_squares, rook_directions);
+  generate_sliding_attacks(attack_table, bishop_squares, bishop_directions);
+#else
+  const char* attack_table_type = "uint8_t";
+  const char* attack_table_name = "magic_attack_table";
+  std::vector<int> attack_indices;
+  std::vector<uint64_t> attack_sets;
+
+  if (not generate_sliding_attacks(attack_indices, attack_sets, rook_squares,
+                                   rook_magic_constants, rook_directions)
+      or not generate_sliding_attacks(attack_indices, attack_sets,
+                                      bishop_squares, bishop_magic_constants,
+                                      bishop_directions)) {
+    return EXIT_FAILURE;
+  }
+
+  std::vector<uint8_t> attack_table;
+  for (auto attack_index : attack_indices) {
+    attack_table.push_back(static_cast<uint8_t>(std::max(attack_index, 0)));
+  }
+#endif
+
+  FILE* output = std::fopen(argv[1], "w");
+
+  if (output == nullptr) {
+    std::perror(argv[1]);
+    return EXIT_FAILURE;
+  }
+
+  std::fprintf(output, "\n/* Generated by kator_attack_table_generator, see "
+                       "tools/attack_table_generator.cc */\n\n");
+  print_table(output, "bitboard::knight_table",
+              knight_table.data(), knight_table.size());
+  print_table(output, "bitboard::king_table",
+              king_table.data(), king_table.size());
+  print_table(output, "bitboard::bishop_pattern_table",
+              bishop_pattern_table.data(), bishop_pattern_table.size());
+  print_table(output, "bitboard::rook_pattern_table",
+              rook_pattern_table.data(), rook_pattern_table.size());
+  print_table(output, "bitboard::rays", rays.data(), rays.size());
+  print_attack_table(output, attack_table_type, attack_table_name,
+                     attack_table);
+#ifndef KATOR_USE_PEXT_BITBOARD
+  print_attack_table(output, "uint64_t", "magic_attack_set_table",
+                     attack_sets);
+#endif
+  print_magics(output, "bitboard::magical::rook", attack_table_name,
+               rook_squares);
+  print_magics(output, "bitboard::magical::bishop", attack_table_name,
+               bishop_squares);
+
+  if (std::fclose(output) != 0) {
+    std::perror(argv[1]);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,291 @@
+
+/* Searching for magic multipliers, and packing the attack tables. {{{
+   The output is the src/chess/magics.inc file, the source of the
+   magic constants used by bitboard.cc. For each square the search
+   tries random sparse multipliers, looking for the one resulting in the
+   smallest table -- allowing collisions between occupancies with the
+   same attack set. It also tries using one or two bits less for the
+   index than the number of relevant occupancy bits, which halves or
+   quarters the table of a square when such a multiplier is found.
+   The tables of all rook and bishop squares are then packed into one
+   shared array, the larger ones first, each one placed at the lowest
+   offset where all of its used entries land on unused entries. The
+   entries are one byte each, selecting one of the distinct attack sets
+   of the square, see tools/attack_table_generator.cc -- thus entries
+   can only be shared within the table of a single square.
+   The search starts from the magics currently built into the program,
+   so running it again never makes the tables bigger.
+
+   usage: kator_magic_generator [tries per square] [seed] > magics.inc
+}}}*/
+
+#include "chess/bitboard.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace ::kator;
+
+namespace
+{
+
+struct square_magic
+{
+  uint64_t mask;
+  std::vector<uint64_t> occupancies;
+  std::vector<uint64_t> attacks;
+  uint64_t multiplier;
+  unsigned shift;
+  size_t size;
+  size_t offset;
+  std::vector<uint64_t> table;
+};
+
+class magic_search
+{
+  std::vector<unsigned> stamps;
+  std::vector<uint64_t> entries;
+  unsigned epoch;
+
+public:
+
+  magic_search(): stamps(1 << 12, 0), entries(1 << 12), epoch(0) {}
+
+  /* Returns the size of the table needed with the multiplier and {{{
+     shift, or zero if it doesn't work, or would not fit into limit.
+  }}}*/
+  size_t try_magic(const square_magic& square,
+                   uint64_t multiplier,
+                   unsigned shift,
+                   size_t limit)
+  {
+    size_t max_index = 0;
+
+    ++epoch;
+    for (size_t i = 0; i < square.occupancies.size(); ++i) {
+      size_t index =
+        static_cast<size_t>((square.occupancies[i] * multiplier) >> shift);
+
+      if (index >= limit) {
+        return 0;
+      }
+      if (stamps[index] == epoch) {
+        if (entries[index] != square.attacks[i]) {
+          return 0;
+        }
+      }
+      else {
+        stamps[index] = epoch;
+        entries[index] = square.attacks[i];
+      }
+      max_index = std::max(max_index, index);
+    }
+    return max_index + 1;
+  }
+
+}; /* class magic_search */
+
+template<typename attack_function>
+square_magic setup_square(uint64_t mask, attack_function attacks_of)
+{
+  square_magic result;
+  bitboard subset = bitboard::empty();
+
+  result.mask = mask;
+  do {
+    result.occupancies.push_back(subset.to_uint64_t());
+    result.attacks.push_back(attacks_of(subset).to_uint64_t());
+    bitboard(mask).generate_next_subset(subset);
+  } while (subset.is_nonempty());
+  result.size = SIZE_MAX;
+  return result;
+}
+
+void search(square_magic& square,
+            magic_search& searcher,
+            std::mt19937_64& random,
+            unsigned long tries)
+{
+  const unsigned bits =
+    static_cast<unsigned>(bitboard(square.mask).popcnt());
+
+  for (unsigned long i = 0; i < tries; ++i) {
+    uint64_t multiplier = random() & random() & random();
+
+    if (bitboard((square.mask * multiplier) >> 56).popcnt() < 6) {
+      continue;
+    }
+    for (unsigned shift = 64 - bits; shift <= 66 - bits; ++shift) {
+      size_t limit = std::min(square.size, size_t(1) << (64 - shift));
+      size_t size = searcher.try_magic(square, multiplier, shift, limit);
+
+      if (size != 0 and size < square.size) {
+        square.multiplier = multiplier;
+        square.shift = shift;
+        square.size = size;
+      }
+    }
+  }
+}
+
+void fill_table(square_magic& square)
+{
+  square.table.assign(square.size, 0);
+  for (size_t i = 0; i < square.occupancies.size(); ++i) {
+    size_t index = static_cast<size_t>(
+        (square.occupancies[i] * square.multiplier) >> square.shift);
+
+    square.table[index] = square.attacks[i];
+  }
+}
+
+bool fits(const std::vector<uint64_t>& shared,
+          const square_magic& square,
+          size_t offset)
+{
+  for (size_t i = 0; i < square.table.size(); ++i) {
+    uint64_t entry = square.table[i];
+
+    if (entry != 0 and offset + i < shared.size()
+        and shared[offset + i] != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* Attack sets are never empty, zero marks the unused entries */
+size_t pack(std::vector<square_magic*> squares)
+{
+  std::vector<uint64_t> shared;
+
+  std::stable_sort(squares.begin(), squares.end(),
+                   [](const square_magic* a, const square_magic* b) {
+                     return a->size > b->size;
+                   });
+  for (auto square : squares) {
+    fill_table(*square);
+
+    size_t offset = 0;
+    while (not fits(shared, *square, offset)) {
+      ++offset;
+    }
+    square->offset = offset;
+    if (shared.size() < offset + square->size) {
+      shared.resize(offset + square->size, 0);
+    }
+    for (size_t i = 0; i < square->size; ++i) {
+      if (square->table[i] != 0) {
+        shared[offset + i] = square->table[i];
+      }
+    }
+  }
+  return shared.size();
+}
+
+void print_constants(const char* name, const std::vector<square_magic>& magics)
+{
+  std::printf("static const std::array<magic_constant, 64> %s = {{\n", name);
+  for (size_t i = 0; i < magics.size(); ++i) {
+    std::printf(" {0x%016" PRIX64 ", %u, %zu}%s\n",
+                magics[i].multiplier, magics[i].shift, magics[i].offset,
+                (i + 1 < magics.size()) ? "," : "");
+  }
+  std::printf("}};\n\n");
+}
+
+} /* anonym namespace */
+
+int main(int argc, char** argv)
+{
+  unsigned long tries = 100000;
+  unsigned long seed = 1;
+
+  if (argc > 1) {
+    tries = std::strtoul(argv[1], nullptr, 10);
+  }
+  if (argc > 2) {
+    seed = std::strtoul(argv[2], nullptr, 10);
+  }
+
+  std::mt19937_64 random(seed);
+  magic_search searcher;
+  std::vector<square_magic> rook_magics;
+  std::vector<square_magic> bishop_magics;
+  size_t unpacked_size = 0;
+
+  for (auto index : sq_index::range()) {
+    const bitboard::magical& rook = bitboard::magical::rook[index.offset()];
+    const bitboard::magical& bishop =
+      bitboard::magical::bishop[index.offset()];
+
+    rook_magics.push_back(setup_square(rook.pre_mask,
+      [index](bitboard occupied) {
+        return bitboard::rook_attacks(occupied, index);
+      }));
+    bishop_magics.push_back(setup_square(bishop.pre_mask,
+      [index](bitboard occupied) {
+        return bitboard::bishop_attacks(occupied, index);
+      }));
+
+#   ifndef KATOR_USE_PEXT_BITBOARD
+    // Start from the magics already known to work
+    for (auto item : { std::make_pair(&rook, &rook_magics.back()),
+                       std::make_pair(&bishop, &bishop_magics.back()) }) {
+      item.second->multiplier = item.first->multiplier;
+      item.second->shift = static_cast<unsigned>(item.first->shift);
+      item.second->size =
+        searcher.try_magic(*item.second, item.first->multiplier,
+                           item.second->shift, SIZE_MAX);
+    }
+#   endif
+
+    search(rook_magics.back(), searcher, random, tries);
+    search(bishop_magics.back(), searcher, random, tries);
+    unpacked_size += rook_magics.back().size + bishop_magics.back().size;
+    std::fprintf(stderr, "%s rook: %zu bishop: %zu\n",
+                 index.to_str().c_str(),
+                 rook_magics.back().size, bishop_magics.back().size);
+  }
+
+  for (auto& item : rook_magics) {
+    if (item.size == SIZE_MAX) {
+      std::fprintf(stderr, "no magic found, try more tries\n");
+      return EXIT_FAILURE;
+    }
+  }
+  for (auto& item : bishop_magics) {
+    if (item.size == SIZE_MAX) {
+      std::fprintf(stderr, "no magic found, try more tries\n");
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::vector<square_magic*> all;
+  for (auto& item : rook_magics) {
+    all.push_back(&item);
+  }
+  for (auto& item : bishop_magics) {
+    all.push_back(&item);
+  }
+
+  size_t size = pack(all);
+
+  std::fprintf(stderr, "table entries: %zu, packed: %zu ( %zu bytes )\n",
+               unpacked_size, size, size * sizeof(uint8_t));
+
+  std::printf("\n/* Generated by kator_magic_generator, see "
+              "tools/magic_generator.cc {{{\n"
+              "   Each entry is a multiplier, a shift, and the offset of the\n"
+              "   square's attacks in the table shared by rooks and bishops.\n"
+              "}}}*/\n\n");
+  print_constants("rook_magic_constants", rook_magics);
+  print_constants("bishop_magic_constants", bishop_magics);
+  std::printf("constexpr size_t magic_attack_table_size = %zu;\n", size);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,24 @@
+
+/* Converting evaluation parameters from the text format to the binary {{{
+   one, see position_value::convert_parameters in engine/eval.h.
+   Keys missing from the text get their default values.
+
+   usage: kator_parameter_converter < parameters.conf > parameters.bin
+}}}*/
+
+#include "engine/eval.h"
+
+#include <cstdlib>
+#include <iostream>
+
+int main()
+{
+  try {
+    ::kator::engine::position_value::convert_parameters(std::cin, std::cout);
+  }
+  catch (...) {
+    std::cerr << "Invalid evaluation parameters\n";
+    return EXIT_FAILURE;
+  }
+  return std::cout.good() ? EXIT_SUCCESS : EXIT_FAILURE;
+}